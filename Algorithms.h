@@ -2,6 +2,14 @@
 #include "NodeInPath.h"
 #include "DijskstraSet.h"
 #include "ThreadPool.h"
+#include "QueryControl.h"
+#include "FlatGraph.h"
+#include "ShortestPathTree.h"
+#include "RelaxationKernel.h"
+#include "CompressedGraph.h"
+#include "ReachabilityIndex.h"
+#include "VersionedGraph.h"
+#include "GraphArena.h"
 
 /// <summary>
 /// finds shortes path in graph using dijstra algorithm
@@ -9,25 +17,35 @@
 /// <param name="graph">definition of graph</param>
 /// <param name="startNodeId">starting node</param>
 /// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
 /// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
-/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+/// <returns>tuple: shortest path(deque) and cost of the path,
+/// if the search was stopped the best path found so far is returned</returns>
 template <typename Cost_t>
 auto dijstraShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
-	id_t startNodeId, id_t endNodeId)
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr)
 {
-	static_assert(is_arithmetic<Cost_t>::value, "type T must be arithmetic");
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
 
 	DijskstraSet<Cost_t> dijstraSet(graph.size());
 
 	dijstraSet.setCost(startNodeId, 0);
 	
-	while (!dijstraSet.isEmpty()) {
+	while (!dijstraSet.isEmpty() && dijstraSet.hasReachableNodes()) {
+
+		if (control != nullptr && control->isStopped()) {
+			break;
+		}
 
 		const auto& [processNodeId, cost] = dijstraSet.pop();
 		const auto& neigbours = graph[processNodeId]->getNeighbours();
 
 		for (const auto& neigbourAndCost : neigbours) {
 
+			if (control != nullptr && control->shouldStop()) {
+				break;
+			}
+
 			const auto& [weakNeighbour, neigbourCost] = neigbourAndCost;
 
 			assert(neigbourCost >= 0);
@@ -43,22 +61,191 @@ auto dijstraShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
 			}
 		}
 	}
+	if (control != nullptr) {
+		control->finish();
+	}
+
 	auto path=dijstraSet.getPath(endNodeId);
 	auto minCost = dijstraSet.getCost(endNodeId);
 
 	return tuple<decltype(path), decltype(minCost)>(path, minCost);
 }
 
+/// <summary>
+/// finds shortes path in flat graph using dijstra algorithm with binary heap,
+/// edges of every node are relaxed by vector instructions when they are available
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const FlatGraph<Cost_t>& graph, id_t startNodeId, id_t endNodeId)
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	using CostAndId = tuple<Cost_t, id_t>;
+
+	ShortestPathTree<Cost_t> tree(graph.getNodeCount(), startNodeId);
+	priority_queue<CostAndId, vector<CostAndId>, greater<CostAndId>> queue;
+
+	tree.costs[startNodeId] = 0;
+	queue.push(CostAndId(tree.costs[startNodeId], startNodeId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		if (processNodeId == endNodeId) {
+			break;
+		}
+		//node was already processed with smaller cost
+		if (tree.costs[processNodeId] < cost) {
+			continue;
+		}
+
+		auto firstEdge = graph.firstEdge(processNodeId);
+
+		relaxEdges(graph.getTargets().data() + firstEdge, graph.getCosts().data() + firstEdge,
+			graph.lastEdge(processNodeId) - firstEdge, cost, tree.costs.data(),
+			[&tree, &queue, processNodeId = processNodeId](id_t neigbourId, Cost_t newNeigbourCost) {
+				tree.prevNodes[neigbourId] = processNodeId;
+				queue.push(CostAndId(newNeigbourCost, neigbourId));
+			});
+	}
+
+	auto path = tree.getPath(endNodeId);
+	auto minCost = tree.getCost(endNodeId);
+
+	return tuple<decltype(path), decltype(minCost)>(path, minCost);
+}
+
+/// <summary>
+/// finds shortes path using dijstra algorithm with binary heap
+/// in any graph which provides getNodeCount and forEachNeighbour
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Graph_t">type of graph, it defines cost_type</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Graph_t>
+auto heapDijstraShortestPath(const Graph_t& graph, id_t startNodeId, id_t endNodeId)
+{
+	using Cost_t = typename Graph_t::cost_type;
+	using CostAndId = tuple<Cost_t, id_t>;
+
+	ShortestPathTree<Cost_t> tree(graph.getNodeCount(), startNodeId);
+	priority_queue<CostAndId, vector<CostAndId>, greater<CostAndId>> queue;
+
+	tree.costs[startNodeId] = 0;
+	queue.push(CostAndId(tree.costs[startNodeId], startNodeId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		if (processNodeId == endNodeId) {
+			break;
+		}
+		//node was already processed with smaller cost
+		if (tree.costs[processNodeId] < cost) {
+			continue;
+		}
+
+		graph.forEachNeighbour(processNodeId,
+			[&tree, &queue, cost = cost, processNodeId = processNodeId](id_t neigbourId, Cost_t neigbourCost) {
+
+				assert(neigbourCost >= 0);
+
+				auto newNeigbourCost = cost + neigbourCost;
+				if (tree.costs[neigbourId] > newNeigbourCost) {
+					tree.costs[neigbourId] = newNeigbourCost;
+					tree.prevNodes[neigbourId] = processNodeId;
+					queue.push(CostAndId(newNeigbourCost, neigbourId));
+				}
+			});
+	}
+
+	auto path = tree.getPath(endNodeId);
+	auto minCost = tree.getCost(endNodeId);
+
+	return tuple<decltype(path), decltype(minCost)>(path, minCost);
+}
+
+/// <summary>
+/// finds shortes path in compressed graph using dijstra algorithm
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path, the cost uses quantised costs of edges</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const CompressedGraph<Cost_t>& graph, id_t startNodeId, id_t endNodeId)
+{
+	return heapDijstraShortestPath(graph, startNodeId, endNodeId);
+}
+
+/// <summary>
+/// finds shortes path in graph built in arena using dijstra algorithm
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const GraphArena<Cost_t>& graph, id_t startNodeId, id_t endNodeId)
+{
+	return heapDijstraShortestPath(graph, startNodeId, endNodeId);
+}
+
+/// <summary>
+/// finds shortes path in snapshot of versioned graph using dijstra algorithm,
+/// the snapshot is not changed by updates published during the search
+/// </summary>
+/// <param name="graph">version of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const GraphSnapshot<Cost_t>& graph, id_t startNodeId, id_t endNodeId)
+{
+	return heapDijstraShortestPath(graph, startNodeId, endNodeId);
+}
+
+/// <summary>
+/// finds shortes path in the last published version of graph using dijstra algorithm
+/// </summary>
+/// <param name="graph">versioned graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const VersionedGraph<Cost_t>& graph, id_t startNodeId, id_t endNodeId)
+{
+	auto snapshot = graph.getSnapshot();
+	return heapDijstraShortestPath(*snapshot, startNodeId, endNodeId);
+}
+
 /// <summary>
 ///  recursive function used only in bellman-ford algorithm
 /// </summary>
 /// <param name="bellSet"></param>
 /// <param name="processedNode"></param>
 /// <param name="threadPool"></param>
+/// <param name="control">optional deadline and cancellation of the search</param>
 /// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
 ///<remarks>recursion uses threads, todo: use thread pool</remarks>
 template <typename Cost_t>
-void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared_ptr<NodeInPath<Cost_t>> processedNode) {
+void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared_ptr<NodeInPath<Cost_t>> processedNode,
+	QueryControl* control) {
 
 	const auto& neigbours = processedNode->getNeighbours();
 	auto processNodeId = processedNode->getId();
@@ -70,6 +257,10 @@ void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared
 
 	for (const auto& neigbourAndCost : neigbours) {
 
+		if (control != nullptr && control->shouldStop()) {
+			break;
+		}
+
 		const auto& [weakNeighbour, edgeCost] = neigbourAndCost;
 
 		auto neighbour = weakNeighbour.lock();
@@ -90,9 +281,9 @@ void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared
 				else {
 					
 					pendingTasks.push_back(threadPool.submit(
-						[&threadPool, &bellSet, &neighbour]()
+						[&threadPool, &bellSet, neighbour, control]()
 						{
-							processNode(threadPool, bellSet, neighbour);
+							processNode(threadPool, bellSet, neighbour, control);
 						}
 					));
 					/*
@@ -113,7 +304,7 @@ void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared
 
 	//and now process the first neigbour
 	if (firstNeigbour != nullptr) {
-		processNode(threadPool, bellSet, firstNeigbour);
+		processNode(threadPool, bellSet, firstNeigbour, control);
 	}
 }
 
@@ -123,22 +314,93 @@ void processNode(ThreadPool& threadPool, BellmanFordSet<Cost_t>& bellSet, shared
 /// <param name="graph">definition of graph</param>
 /// <param name="startNodeId">starting node in the path</param>
 /// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
 /// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
-/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+/// <returns>tuple: shortest path(deque) and cost of the path,
+/// if the search was stopped the best path found so far is returned</returns>
 template <typename Cost_t>
 auto bellmanFordShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
-	id_t startNodeId, id_t endNodeId) {
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr) {
 	
-	static_assert(is_arithmetic<Cost_t>::value, "type T must be arithmetic");
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
 	
 	BellmanFordSet<Cost_t> bellFordSet(graph.size());
 	ThreadPool threadPool;
 
 	bellFordSet.setCost(startNodeId, 0);
-	processNode(threadPool, bellFordSet, graph[startNodeId]);
+	processNode(threadPool, bellFordSet, graph[startNodeId], control);
+
+	if (control != nullptr) {
+		control->finish();
+	}
 	
 	auto path = bellFordSet.getPath(endNodeId);
 	auto minCost = bellFordSet.getCost(endNodeId);
 
 	return tuple<decltype(path), decltype(minCost)>(path, minCost);
 }
+
+/// <summary>
+/// finds shortes path using dijstra algorithm, the search is not started
+/// when reachability index proves that there is no path
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="reachability">index built for the graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, const ReachabilityIndex& reachability,
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr)
+{
+	if (reachability.isUnreachable(startNodeId, endNodeId)) {
+		return tuple<deque<id_t>, Cost_t>(deque<id_t>{ endNodeId }, numeric_limits<Cost_t>::max());
+	}
+
+	return dijstraShortestPath(graph, startNodeId, endNodeId, control);
+}
+
+/// <summary>
+/// finds shortes path in flat graph using dijstra algorithm, the search is not started
+/// when reachability index proves that there is no path
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="reachability">index built for the graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto dijstraShortestPath(const FlatGraph<Cost_t>& graph, const ReachabilityIndex& reachability,
+	id_t startNodeId, id_t endNodeId)
+{
+	if (reachability.isUnreachable(startNodeId, endNodeId)) {
+		return tuple<deque<id_t>, Cost_t>(deque<id_t>{ endNodeId }, numeric_limits<Cost_t>::max());
+	}
+
+	return dijstraShortestPath(graph, startNodeId, endNodeId);
+}
+
+/// <summary>
+/// finds shortes path using bellman-ford algorithm, the search is not started
+/// when reachability index proves that there is no path
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="reachability">index built for the graph</param>
+/// <param name="startNodeId">starting node in the path</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+template <typename Cost_t>
+auto bellmanFordShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, const ReachabilityIndex& reachability,
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr)
+{
+	if (reachability.isUnreachable(startNodeId, endNodeId)) {
+		return tuple<deque<id_t>, Cost_t>(deque<id_t>{ endNodeId }, numeric_limits<Cost_t>::max());
+	}
+
+	return bellmanFordShortestPath(graph, startNodeId, endNodeId, control);
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+#include "Algorithms.h"
+
+/// <summary>
+/// result of query which was stopped before it started
+/// </summary>
+/// <param name="endNodeId">last node in searching path</param>
+/// <typeparm name="Cost_t">type of cost betwean two nodes</typeparm>
+/// <returns>tuple: path with only the end node and maximal cost</returns>
+template <typename Cost_t>
+tuple<deque<id_t>, Cost_t> skippedQueryResult(id_t endNodeId)
+{
+	return tuple<deque<id_t>, Cost_t>(deque<id_t>{ endNodeId }, numeric_limits<Cost_t>::max());
+}
+
+/// <summary>
+/// submits dijstra search to thread pool
+/// </summary>
+/// <param name="threadPool">pool which runs the search</param>
+/// <param name="graph">definition of graph, it must live until the future is ready</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>future of tuple: shortest path(deque) and cost of the path</returns>
+/// <remarks>
+/// if the deadline passed while the query was waiting in the queue
+/// the search is not started, status of control tells how the query ended
+/// </remarks>
+template <typename Cost_t>
+future<tuple<deque<id_t>, Cost_t>> dijstraShortestPathAsync(ThreadPool& threadPool,
+	const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	id_t startNodeId, id_t endNodeId, shared_ptr<QueryControl> control)
+{
+	return threadPool.submit<tuple<deque<id_t>, Cost_t>>([&graph, startNodeId, endNodeId, control]()
+		{
+			if (control->check()) {
+				return skippedQueryResult<Cost_t>(endNodeId);
+			}
+
+			auto [path, cost] = dijstraShortestPath(graph, startNodeId, endNodeId, control.get());
+			return tuple<deque<id_t>, Cost_t>(move(path), cost);
+		});
+}
+
+/// <summary>
+/// submits bellman-ford search to thread pool
+/// </summary>
+/// <param name="threadPool">pool which runs the search</param>
+/// <param name="graph">definition of graph, it must live until the future is ready</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>future of tuple: shortest path(deque) and cost of the path</returns>
+/// <remarks>
+/// if the deadline passed while the query was waiting in the queue
+/// the search is not started, status of control tells how the query ended
+/// </remarks>
+template <typename Cost_t>
+future<tuple<deque<id_t>, Cost_t>> bellmanFordShortestPathAsync(ThreadPool& threadPool,
+	const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	id_t startNodeId, id_t endNodeId, shared_ptr<QueryControl> control)
+{
+	return threadPool.submit<tuple<deque<id_t>, Cost_t>>([&graph, startNodeId, endNodeId, control]()
+		{
+			if (control->check()) {
+				return skippedQueryResult<Cost_t>(endNodeId);
+			}
+
+			auto [path, cost] = bellmanFordShortestPath(graph, startNodeId, endNodeId, control.get());
+			return tuple<deque<id_t>, Cost_t>(move(path), cost);
+		});
+}
@@ -0,0 +1,379 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ThreadPool.h"
+
+/// <summary>
+/// single source searches of Brandes algorithm, it keeps memory of one search
+/// and adds dependencies of every source to accumulator
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>one worker must be used only by one thread</remarks>
+template <typename Cost_t>
+class BrandesWorker
+{
+public:
+	/// <summary>
+	/// creates memory for searches
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="predecessorOffsets">index of first predecessor slot of every node, computed from numbers of incoming edges</param>
+	/// <param name="weighted">true for costs of edges, false for number of edges</param>
+	BrandesWorker(const FlatGraph<Cost_t>& graph, const vector<size_t>& predecessorOffsets, bool weighted);
+
+	/// <summary>
+	/// finds shortest paths from source, counts them and adds dependencies of all nodes to accumulator
+	/// </summary>
+	/// <param name="sourceId">source node</param>
+	/// <param name="centrality">accumulator of centrality of every node</param>
+	/// <param name="scale">multiplier of dependencies</param>
+	void addSource(id_t sourceId, vector<double>& centrality, double scale);
+
+private:
+	/// <summary>
+	/// dijstra algorithm which counts shortest paths
+	/// </summary>
+	void searchWeighted(id_t sourceId);
+
+	/// <summary>
+	/// breadth first search which counts shortest paths
+	/// </summary>
+	void searchUnweighted(id_t sourceId);
+
+	/// <summary>
+	/// adds node as predecessor on shortest path
+	/// </summary>
+	void addPredecessor(id_t id, id_t predecessorId)
+	{
+		predecessors[predecessorOffsets[id] + predecessorCounts[id]++] = predecessorId;
+	}
+
+	const FlatGraph<Cost_t>& graph;
+
+	/// <summary>
+	/// index of first predecessor slot of every node
+	/// </summary>
+	const vector<size_t>& predecessorOffsets;
+
+	bool weighted;
+
+	/// <summary>
+	/// cost of every node in weighted search
+	/// </summary>
+	vector<Cost_t> costs;
+
+	/// <summary>
+	/// number of edges from source for every node in unweighted search
+	/// </summary>
+	vector<id_t> levels;
+
+	/// <summary>
+	/// number of shortest paths from source to every node
+	/// </summary>
+	vector<double> pathCounts;
+
+	/// <summary>
+	/// dependency of source on every node
+	/// </summary>
+	vector<double> dependencies;
+
+	/// <summary>
+	/// predecessors on shortest paths, slots of node start at predecessorOffsets
+	/// </summary>
+	vector<id_t> predecessors;
+
+	/// <summary>
+	/// number of predecessors of every node
+	/// </summary>
+	vector<id_t> predecessorCounts;
+
+	/// <summary>
+	/// reached nodes in order of nondecreasing distance from source
+	/// </summary>
+	vector<id_t> order;
+};
+
+/// <summary>
+/// computes betweenness centrality of all nodes using Brandes algorithm,
+/// sources are searched in parallel and every task has its own accumulator
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="sources">searched sources</param>
+/// <param name="scale">multiplier of dependencies</param>
+/// <param name="weighted">true for costs of edges, false for number of edges</param>
+/// <param name="threadPool">optional pool used to search sources in parallel</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>centrality of every node</returns>
+template <typename Cost_t>
+vector<double> accumulateBetweenness(const FlatGraph<Cost_t>& graph, const vector<id_t>& sources, double scale,
+	bool weighted, ThreadPool* threadPool)
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	auto size = graph.getNodeCount();
+
+	//predecessors of node are at most its incoming edges
+	vector<size_t> predecessorOffsets(static_cast<size_t>(size) + 1, 0);
+	for (auto target : graph.getTargets()) {
+		predecessorOffsets[target + 1]++;
+	}
+	for (id_t id = 0; id < size; id++) {
+		predecessorOffsets[id + 1] += predecessorOffsets[id];
+	}
+
+	vector<double> centrality(size, 0);
+
+	if (threadPool == nullptr || sources.size() < 2) {
+		BrandesWorker<Cost_t> worker(graph, predecessorOffsets, weighted);
+
+		for (auto sourceId : sources) {
+			worker.addSource(sourceId, centrality, scale);
+		}
+		return centrality;
+	}
+
+	//tasks take sources one by one, so long searches do not stop other tasks
+	auto taskCount = min(threadPool->getThreadCount(), sources.size());
+	vector<vector<double>> accumulators(taskCount);
+	atomic<size_t> nextSource = 0;
+	deque<future<void>> pendingTasks;
+
+	for (size_t task = 0; task < taskCount; task++) {
+		pendingTasks.push_back(threadPool->submit([&, task]() {
+			BrandesWorker<Cost_t> worker(graph, predecessorOffsets, weighted);
+			accumulators[task].assign(size, 0);
+
+			for (auto source = nextSource++; source < sources.size(); source = nextSource++) {
+				worker.addSource(sources[source], accumulators[task], scale);
+			}
+		}));
+	}
+
+	for (auto& task : pendingTasks) {
+		task.get();
+	}
+
+	for (const auto& accumulator : accumulators) {
+		for (id_t id = 0; id < size; id++) {
+			centrality[id] += accumulator[id];
+		}
+	}
+
+	return centrality;
+}
+
+/// <summary>
+/// computes betweenness centrality of all nodes: sum of fractions of shortest paths
+/// betwean all ordered pairs of other nodes which go through the node
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="weighted">true for costs of edges, costs must be positive; false for number of edges</param>
+/// <param name="threadPool">optional pool used to search sources in parallel</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>centrality of every node</returns>
+/// <remarks>it takes O(VE + V^2 log V) time, for large graphs use approximateBetweennessCentrality</remarks>
+template <typename Cost_t>
+vector<double> betweennessCentrality(const FlatGraph<Cost_t>& graph, bool weighted = true, ThreadPool* threadPool = nullptr)
+{
+	vector<id_t> sources(graph.getNodeCount());
+
+	for (id_t id = 0; id < graph.getNodeCount(); id++) {
+		sources[id] = id;
+	}
+
+	return accumulateBetweenness(graph, sources, 1.0, weighted, threadPool);
+}
+
+/// <summary>
+/// computes betweenness centrality of all nodes of graph made of nodes
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="weighted">true for costs of edges, costs must be positive; false for number of edges</param>
+/// <param name="threadPool">optional pool used to search sources in parallel</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>centrality of every node</returns>
+template <typename Cost_t>
+vector<double> betweennessCentrality(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, bool weighted = true,
+	ThreadPool* threadPool = nullptr)
+{
+	return betweennessCentrality(FlatGraph<Cost_t>(graph), weighted, threadPool);
+}
+
+/// <summary>
+/// number of random sources needed by approximateBetweennessCentrality,
+/// it follows from Hoeffding bound and union bound over all nodes
+/// </summary>
+/// <param name="nodeCount">number of nodes</param>
+/// <param name="maxError">allowed error of centrality divided by (n - 1)(n - 2)</param>
+/// <param name="failureProbability">probability that error of any node is bigger</param>
+/// <returns>ceil(ln(2n / failureProbability) / (2 maxError^2)), at most number of nodes</returns>
+inline id_t betweennessSampleSize(id_t nodeCount, double maxError, double failureProbability)
+{
+	if (nodeCount == 0) {
+		return 0;
+	}
+
+	auto sampleSize = ceil(log(2.0 * nodeCount / failureProbability) / (2 * maxError * maxError));
+
+	return static_cast<id_t>(min(sampleSize, static_cast<double>(nodeCount)));
+}
+
+/// <summary>
+/// estimates betweenness centrality from searches of random sources,
+/// dependencies are multiplied by n / k
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="maxError">allowed error of centrality divided by (n - 1)(n - 2)</param>
+/// <param name="failureProbability">probability that error of any node is bigger</param>
+/// <param name="weighted">true for costs of edges, costs must be positive; false for number of edges</param>
+/// <param name="threadPool">optional pool used to search sources in parallel</param>
+/// <param name="seed">seed of random sources</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>estimated centrality of every node, exact if sample contains all nodes</returns>
+template <typename Cost_t>
+vector<double> approximateBetweennessCentrality(const FlatGraph<Cost_t>& graph, double maxError,
+	double failureProbability = 0.1, bool weighted = true, ThreadPool* threadPool = nullptr, unsigned int seed = 1)
+{
+	auto size = graph.getNodeCount();
+	auto sampleSize = betweennessSampleSize(size, maxError, failureProbability);
+
+	vector<id_t> sources(size);
+	for (id_t id = 0; id < size; id++) {
+		sources[id] = id;
+	}
+
+	//sources without repetition
+	mt19937 random(seed);
+	for (id_t i = 0; i < sampleSize; i++) {
+		uniform_int_distribution<id_t> distribution(i, size - 1);
+		swap(sources[i], sources[distribution(random)]);
+	}
+	sources.resize(sampleSize);
+
+	return accumulateBetweenness(graph, sources, static_cast<double>(size) / max<id_t>(sampleSize, 1), weighted, threadPool);
+}
+
+template<typename Cost_t>
+inline BrandesWorker<Cost_t>::BrandesWorker(const FlatGraph<Cost_t>& graph, const vector<size_t>& predecessorOffsets, bool weighted)
+	:graph(graph), predecessorOffsets(predecessorOffsets), weighted(weighted),
+	pathCounts(graph.getNodeCount(), 0), dependencies(graph.getNodeCount(), 0),
+	predecessors(graph.getEdgeCount()), predecessorCounts(graph.getNodeCount(), 0)
+{
+	if (weighted) {
+		costs.assign(graph.getNodeCount(), numeric_limits<Cost_t>::max());
+	}
+	else {
+		levels.assign(graph.getNodeCount(), numeric_limits<id_t>::max());
+	}
+	order.reserve(graph.getNodeCount());
+}
+
+template<typename Cost_t>
+inline void BrandesWorker<Cost_t>::addSource(id_t sourceId, vector<double>& centrality, double scale)
+{
+	order.clear();
+
+	if (weighted) {
+		searchWeighted(sourceId);
+	}
+	else {
+		searchUnweighted(sourceId);
+	}
+
+	//dependencies are accumulated from the farthest nodes
+	for (auto it = order.rbegin(); it != order.rend(); ++it) {
+		auto id = *it;
+		auto firstPredecessor = predecessorOffsets[id];
+
+		for (auto slot = firstPredecessor; slot < firstPredecessor + predecessorCounts[id]; slot++) {
+			auto predecessorId = predecessors[slot];
+			dependencies[predecessorId] += pathCounts[predecessorId] / pathCounts[id] * (1 + dependencies[id]);
+		}
+
+		if (id != sourceId) {
+			centrality[id] += scale * dependencies[id];
+		}
+	}
+
+	//only reached nodes are cleared
+	for (auto id : order) {
+		pathCounts[id] = 0;
+		dependencies[id] = 0;
+		predecessorCounts[id] = 0;
+		if (weighted) {
+			costs[id] = numeric_limits<Cost_t>::max();
+		}
+		else {
+			levels[id] = numeric_limits<id_t>::max();
+		}
+	}
+}
+
+template<typename Cost_t>
+inline void BrandesWorker<Cost_t>::searchWeighted(id_t sourceId)
+{
+	using CostAndId = tuple<Cost_t, id_t>;
+
+	priority_queue<CostAndId, vector<CostAndId>, greater<CostAndId>> queue;
+
+	costs[sourceId] = 0;
+	pathCounts[sourceId] = 1;
+	queue.push(CostAndId(costs[sourceId], sourceId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		//node was already processed with smaller cost
+		if (costs[processNodeId] < cost) {
+			continue;
+		}
+		order.push_back(processNodeId);
+
+		graph.forEachNeighbour(processNodeId, [&, cost = cost, processNodeId = processNodeId](id_t neigbourId, Cost_t neigbourCost) {
+
+			assert(neigbourCost > 0);
+
+			auto newNeigbourCost = cost + neigbourCost;
+
+			if (costs[neigbourId] > newNeigbourCost) {
+				costs[neigbourId] = newNeigbourCost;
+				pathCounts[neigbourId] = pathCounts[processNodeId];
+				predecessorCounts[neigbourId] = 0;
+				addPredecessor(neigbourId, processNodeId);
+				queue.push(CostAndId(newNeigbourCost, neigbourId));
+			}
+			else if (costs[neigbourId] == newNeigbourCost) {
+				pathCounts[neigbourId] += pathCounts[processNodeId];
+				addPredecessor(neigbourId, processNodeId);
+			}
+		});
+	}
+}
+
+template<typename Cost_t>
+inline void BrandesWorker<Cost_t>::searchUnweighted(id_t sourceId)
+{
+	//order is also the queue of search
+	levels[sourceId] = 0;
+	pathCounts[sourceId] = 1;
+	order.push_back(sourceId);
+
+	for (size_t next = 0; next < order.size(); next++) {
+		auto processNodeId = order[next];
+		auto newLevel = levels[processNodeId] + 1;
+
+		for (auto edge = graph.firstEdge(processNodeId); edge < graph.lastEdge(processNodeId); edge++) {
+			auto neigbourId = graph.getTarget(edge);
+
+			if (levels[neigbourId] == numeric_limits<id_t>::max()) {
+				levels[neigbourId] = newLevel;
+				order.push_back(neigbourId);
+			}
+			if (levels[neigbourId] == newLevel) {
+				pathCounts[neigbourId] += pathCounts[processNodeId];
+				addPredecessor(neigbourId, processNodeId);
+			}
+		}
+	}
+}
@@ -0,0 +1,337 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ThreadPool.h"
+#include "BitOps.h"
+
+/// <summary>
+/// breadth first search for graphs where every edge has the same cost,
+/// it switches betwean top-down and bottom-up expansion of frontier
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// costs of edges are ignored, cost of path is number of edges,
+/// frontiers are bitmaps scanned in parallel when thread pool is given,
+/// state of search is stored in the engine, so searches on one engine are serialized,
+/// concurrent queries need one engine per thread
+/// </remarks>
+template <typename Cost_t>
+class BfsEngine
+{
+public:
+	/// <summary>
+	/// value of parents for nodes which are not reached
+	/// </summary>
+	static constexpr id_t noNode = numeric_limits<id_t>::max();
+
+	/// <summary>
+	/// prepares engine for graph made of nodes
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="threadPool">optional pool used to scan frontiers</param>
+	/// <param name="minWordsInTask">the smallest number of bitmap words scanned by one task</param>
+	BfsEngine(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, ThreadPool* threadPool = nullptr, size_t minWordsInTask = 64)
+		:BfsEngine(FlatGraph<Cost_t>(graph), threadPool, minWordsInTask) {}
+
+	/// <summary>
+	/// prepares engine for flat graph
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="threadPool">optional pool used to scan frontiers</param>
+	/// <param name="minWordsInTask">the smallest number of bitmap words scanned by one task</param>
+	BfsEngine(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool = nullptr, size_t minWordsInTask = 64);
+
+	/// <summary>
+	/// finds path with the smallest number of edges
+	/// </summary>
+	/// <param name="startNodeId">starting node</param>
+	/// <param name="endNodeId">last node in searching path</param>
+	/// <returns>tuple: shortest path(deque) and number of edges in the path</returns>
+	/// <remarks>other calls on the same engine wait until this search is finished</remarks>
+	tuple<deque<id_t>, Cost_t> shortestPath(id_t startNodeId, id_t endNodeId);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of tasks submitted to pool during the last search</returns>
+	size_t getSubmittedTaskCount() const { return submittedTasks; }
+
+private:
+	/// <summary>
+	/// number of nodes and edges added to next frontier
+	/// </summary>
+	using StepResult = tuple<size_t, size_t>;
+
+	/// <summary>
+	/// when frontier has more edges than unexplored edges divided by alpha
+	/// search switches to bottom-up
+	/// </summary>
+	static constexpr size_t alpha = 14;
+
+	/// <summary>
+	/// when frontier has less nodes than all nodes divided by beta
+	/// search switches back to top-down
+	/// </summary>
+	static constexpr size_t beta = 24;
+
+	/// <summary>
+	/// nodes of frontier visit their neighbours
+	/// </summary>
+	/// <param name="firstWord">first word of frontier bitmap to scan</param>
+	/// <param name="lastWord">word after the last word to scan</param>
+	/// <returns>number of nodes and edges added to next frontier</returns>
+	StepResult topDownStep(size_t firstWord, size_t lastWord);
+
+	/// <summary>
+	/// not visited nodes look for a parent in frontier
+	/// </summary>
+	/// <param name="firstWord">first word of next frontier bitmap to fill</param>
+	/// <param name="lastWord">word after the last word to fill</param>
+	/// <returns>number of nodes and edges added to next frontier</returns>
+	StepResult bottomUpStep(size_t firstWord, size_t lastWord);
+
+	/// <summary>
+	/// splits words of bitmap betwean threads of pool
+	/// </summary>
+	/// <param name="step">function called for every range of words</param>
+	/// <returns>sum of results of all ranges</returns>
+	template <typename Step_t>
+	StepResult runStep(Step_t&& step);
+
+	/// <summary>
+	/// outgoing edges
+	/// </summary>
+	FlatGraph<Cost_t> graph;
+
+	/// <summary>
+	/// incoming edges, used by bottom-up step
+	/// </summary>
+	FlatGraph<Cost_t> reversedGraph;
+
+	/// <summary>
+	/// pool used to scan frontiers, nullptr if search is done in current thread
+	/// </summary>
+	ThreadPool* threadPool;
+
+	/// <summary>
+	/// ranges of frontier smaller than this are not worth a task
+	/// </summary>
+	size_t minWordsInTask;
+
+	/// <summary>
+	/// number of tasks submitted to pool during the last search
+	/// </summary>
+	size_t submittedTasks = 0;
+
+	/// <summary>
+	/// held by the running search, state of engine is used by one search at a time
+	/// </summary>
+	mutex searchMtx;
+
+	/// <summary>
+	/// parent of every node in search tree
+	/// </summary>
+	vector<atomic<id_t>> parents;
+
+	/// <summary>
+	/// nodes visited in last step, one bit for every node
+	/// </summary>
+	vector<atomic<uint64_t>> frontier;
+
+	/// <summary>
+	/// nodes visited in current step
+	/// </summary>
+	vector<atomic<uint64_t>> nextFrontier;
+};
+
+template<typename Cost_t>
+inline BfsEngine<Cost_t>::BfsEngine(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool, size_t minWordsInTask)
+	:graph(graph), reversedGraph(graph.reversed()), threadPool(threadPool), minWordsInTask(max<size_t>(minWordsInTask, 1)),
+	parents(graph.getNodeCount()), frontier((graph.getNodeCount() + 63) / 64), nextFrontier(frontier.size())
+{
+}
+
+template<typename Cost_t>
+tuple<deque<id_t>, Cost_t> BfsEngine<Cost_t>::shortestPath(id_t startNodeId, id_t endNodeId)
+{
+	lock_guard<mutex> lock(searchMtx);
+
+	size_t size = graph.getNodeCount();
+	submittedTasks = 0;
+
+	for (auto& parent : parents) {
+		parent.store(noNode, memory_order_relaxed);
+	}
+	for (auto& word : frontier) {
+		word.store(0, memory_order_relaxed);
+	}
+
+	parents[startNodeId] = startNodeId;
+	frontier[startNodeId / 64] = uint64_t(1) << (startNodeId % 64);
+
+	size_t frontierNodes = 1;
+	size_t frontierEdges = graph.lastEdge(startNodeId) - graph.firstEdge(startNodeId);
+	size_t unexploredEdges = graph.getEdgeCount() - frontierEdges;
+	bool bottomUp = false;
+
+	while (frontierNodes > 0 && parents[endNodeId] == noNode) {
+
+		if (!bottomUp && frontierEdges > unexploredEdges / alpha) {
+			bottomUp = true;
+		}
+		else if (bottomUp && frontierNodes < size / beta) {
+			bottomUp = false;
+		}
+
+		for (auto& word : nextFrontier) {
+			word.store(0, memory_order_relaxed);
+		}
+
+		StepResult added;
+		if (bottomUp) {
+			added = runStep([this](size_t firstWord, size_t lastWord) { return bottomUpStep(firstWord, lastWord); });
+		}
+		else {
+			added = runStep([this](size_t firstWord, size_t lastWord) { return topDownStep(firstWord, lastWord); });
+		}
+
+		tie(frontierNodes, frontierEdges) = added;
+		unexploredEdges -= min(unexploredEdges, frontierEdges);
+		frontier.swap(nextFrontier);
+	}
+
+	deque<id_t> path{ endNodeId };
+
+	if (parents[endNodeId] == noNode) {
+		return tuple<deque<id_t>, Cost_t>(path, numeric_limits<Cost_t>::max());
+	}
+
+	for (auto id = endNodeId; id != startNodeId; id = parents[id]) {
+		path.push_front(parents[id]);
+	}
+
+	return tuple<deque<id_t>, Cost_t>(path, static_cast<Cost_t>(path.size() - 1));
+}
+
+template<typename Cost_t>
+typename BfsEngine<Cost_t>::StepResult BfsEngine<Cost_t>::topDownStep(size_t firstWord, size_t lastWord)
+{
+	size_t addedNodes = 0;
+	size_t addedEdges = 0;
+
+	for (auto word = firstWord; word < lastWord; word++) {
+		for (auto bits = frontier[word].load(memory_order_relaxed); bits != 0; bits &= bits - 1) {
+
+			auto processNodeId = static_cast<id_t>(word * 64 + countTrailingZeros(bits));
+
+			for (auto edge = graph.firstEdge(processNodeId); edge < graph.lastEdge(processNodeId); edge++) {
+
+				auto neigbourId = graph.getTarget(edge);
+				auto expected = noNode;
+
+				if (parents[neigbourId].load(memory_order_relaxed) == noNode &&
+					parents[neigbourId].compare_exchange_strong(expected, processNodeId, memory_order_relaxed)) {
+
+					nextFrontier[neigbourId / 64].fetch_or(uint64_t(1) << (neigbourId % 64), memory_order_relaxed);
+					addedNodes++;
+					addedEdges += graph.lastEdge(neigbourId) - graph.firstEdge(neigbourId);
+				}
+			}
+		}
+	}
+
+	return StepResult(addedNodes, addedEdges);
+}
+
+template<typename Cost_t>
+typename BfsEngine<Cost_t>::StepResult BfsEngine<Cost_t>::bottomUpStep(size_t firstWord, size_t lastWord)
+{
+	size_t addedNodes = 0;
+	size_t addedEdges = 0;
+	id_t size = graph.getNodeCount();
+
+	for (auto word = firstWord; word < lastWord; word++) {
+
+		//every word is filled by one thread only
+		uint64_t nextBits = 0;
+		auto lastId = static_cast<id_t>(min<size_t>(size, (word + 1) * 64));
+
+		for (auto id = static_cast<id_t>(word * 64); id < lastId; id++) {
+
+			if (parents[id].load(memory_order_relaxed) != noNode) {
+				continue;
+			}
+
+			for (auto edge = reversedGraph.firstEdge(id); edge < reversedGraph.lastEdge(id); edge++) {
+
+				auto parentId = reversedGraph.getTarget(edge);
+
+				if (frontier[parentId / 64].load(memory_order_relaxed) & (uint64_t(1) << (parentId % 64))) {
+					parents[id].store(parentId, memory_order_relaxed);
+					nextBits |= uint64_t(1) << (id % 64);
+					addedNodes++;
+					addedEdges += graph.lastEdge(id) - graph.firstEdge(id);
+					break;
+				}
+			}
+		}
+
+		nextFrontier[word].store(nextBits, memory_order_relaxed);
+	}
+
+	return StepResult(addedNodes, addedEdges);
+}
+
+template<typename Cost_t>
+template<typename Step_t>
+typename BfsEngine<Cost_t>::StepResult BfsEngine<Cost_t>::runStep(Step_t&& step)
+{
+	auto words = frontier.size();
+	size_t taskCount = threadPool == nullptr ? 1 : min(threadPool->getThreadCount() * 4, words / minWordsInTask);
+
+	if (taskCount <= 1) {
+		return step(0, words);
+	}
+
+	vector<StepResult> results(taskCount);
+	deque<future<void>> pendingTasks;
+	submittedTasks += taskCount;
+
+	for (size_t i = 0; i < taskCount; i++) {
+		auto firstWord = words * i / taskCount;
+		auto lastWord = words * (i + 1) / taskCount;
+
+		pendingTasks.push_back(threadPool->submit([&step, &results, i, firstWord, lastWord]() {
+			results[i] = step(firstWord, lastWord);
+			}));
+	}
+
+	for (const auto& task : pendingTasks) {
+		task.wait();
+	}
+
+	StepResult sum(0, 0);
+	for (const auto& [nodes, edges] : results) {
+		get<0>(sum) += nodes;
+		get<1>(sum) += edges;
+	}
+
+	return sum;
+}
+
+/// <summary>
+/// finds path with the smallest number of edges using breadth first search
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="threadPool">optional pool used to scan frontiers</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque) and number of edges in the path</returns>
+/// <remarks>for many queries on one graph create BfsEngine once</remarks>
+template <typename Cost_t>
+auto bfsShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	id_t startNodeId, id_t endNodeId, ThreadPool* threadPool = nullptr)
+{
+	BfsEngine<Cost_t> engine(graph, threadPool);
+	return engine.shortestPath(startNodeId, endNodeId);
+}
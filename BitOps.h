@@ -0,0 +1,29 @@
+#pragma once
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+/// <summary>
+/// index of the lowest set bit
+/// </summary>
+/// <param name="bits">value, must not be zero</param>
+/// <returns>number of zero bits before the lowest set bit</returns>
+inline unsigned int countTrailingZeros(uint64_t bits)
+{
+	assert(bits != 0);
+#if defined(_MSC_VER) && defined(_M_IX86)
+	//64 bit scan is not available on x86
+	unsigned long index;
+	if (_BitScanForward(&index, static_cast<unsigned long>(bits))) {
+		return index;
+	}
+	_BitScanForward(&index, static_cast<unsigned long>(bits >> 32));
+	return index + 32;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, bits);
+	return index;
+#else
+	return __builtin_ctzll(bits);
+#endif
+}
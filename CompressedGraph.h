@@ -0,0 +1,374 @@
+#pragma once
+#include "FlatGraph.h"
+
+/// <summary>
+/// read only graph with compressed neighbours: sorted ids of neighbours
+/// are stored as varint deltas and costs are quantised to fixed number of bits
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// costs are rounded to weightBits bits, so cost of path can differ from
+/// the original graph, max error of one edge is given by getMaxQuantisationError,
+/// by default integral costs use enough bits to be stored exactly and other costs use 8 bits
+/// </remarks>
+template <typename Cost_t>
+class CompressedGraph
+{
+public:
+	using cost_type = Cost_t;
+
+	/// <summary>
+	/// decodes neighbours of one node
+	/// </summary>
+	class NeighbourDecoder
+	{
+	public:
+		NeighbourDecoder(const CompressedGraph& graph, id_t id);
+
+		/// <summary>
+		/// decodes next neighbour
+		/// </summary>
+		/// <param name="neigbourId">id of neighbour</param>
+		/// <param name="cost">cost of edge to neighbour</param>
+		/// <returns>false if there is no more neighbours</returns>
+		bool next(id_t& neigbourId, Cost_t& cost);
+
+	private:
+		const CompressedGraph& graph;
+
+		/// <summary>
+		/// next byte of ids
+		/// </summary>
+		const uint8_t* position;
+
+		/// <summary>
+		/// index of next edge
+		/// </summary>
+		size_t edge;
+
+		/// <summary>
+		/// index after the last edge of node
+		/// </summary>
+		size_t lastEdge;
+
+		/// <summary>
+		/// previous neighbour, the first delta is computed from id of node
+		/// </summary>
+		id_t previousId;
+
+		/// <summary>
+		/// is the next neighbour the first one
+		/// </summary>
+		bool first = true;
+	};
+
+	/// <summary>
+	/// compresses flat graph
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="weightBits">number of bits of every cost, from 1 to 32, 0 selects default</param>
+	CompressedGraph(const FlatGraph<Cost_t>& graph, unsigned int weightBits = 0);
+
+	/// <summary>
+	/// compresses graph made of nodes
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="weightBits">number of bits of every cost, from 1 to 32, 0 selects default</param>
+	CompressedGraph(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, unsigned int weightBits = 0)
+		:CompressedGraph(FlatGraph<Cost_t>(graph), weightBits) {}
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of nodes</returns>
+	id_t getNodeCount() const { return static_cast<id_t>(edgeOffsets.size() - 1); }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of edges</returns>
+	size_t getEdgeCount() const { return edgeOffsets.back(); }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of bytes used by the graph</returns>
+	size_t getMemorySize() const;
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>the biggest difference betwean original and stored cost of edge</returns>
+	double getMaxQuantisationError() const { return maxQuantisationError; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of bits of every cost</returns>
+	unsigned int getWeightBits() const { return weightBits; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>decoder of neighbours of the node</returns>
+	NeighbourDecoder neighbours(id_t id) const { return NeighbourDecoder(*this, id); }
+
+	/// <summary>
+	/// calls function for every neighbour of node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <param name="func">function called with id of neighbour and cost</param>
+	template <typename Func_t>
+	void forEachNeighbour(id_t id, Func_t&& func) const;
+
+private:
+	/// <summary>
+	/// appends number as varint, 7 bits in every byte
+	/// </summary>
+	void writeVarint(uint64_t value);
+
+	/// <summary>
+	/// quantised cost of edge
+	/// </summary>
+	/// <param name="edge">index of edge</param>
+	/// <returns>stored cost</returns>
+	Cost_t decodeCost(size_t edge) const;
+
+	/// <summary>
+	/// number of bits used when no number is given
+	/// </summary>
+	/// <param name="graph">compressed graph</param>
+	/// <returns>bits which store integral costs exactly, up to 32 bits, 8 bits for other costs</returns>
+	static unsigned int defaultWeightBits(const FlatGraph<Cost_t>& graph);
+
+	/// <summary>
+	/// index of first edge for every node, the last item is number of edges
+	/// </summary>
+	vector<size_t> edgeOffsets;
+
+	/// <summary>
+	/// index of first byte of ids for every node
+	/// </summary>
+	vector<size_t> idOffsets;
+
+	/// <summary>
+	/// varint deltas of neighbours, the first delta of node is zigzag encoded difference from id of node
+	/// </summary>
+	vector<uint8_t> ids;
+
+	/// <summary>
+	/// quantised costs, weightBits bits for every edge
+	/// </summary>
+	vector<uint64_t> weights;
+
+	/// <summary>
+	/// number of bits of every cost
+	/// </summary>
+	unsigned int weightBits;
+
+	/// <summary>
+	/// the smallest cost in graph
+	/// </summary>
+	double minCost = 0;
+
+	/// <summary>
+	/// difference betwean two following quantised costs
+	/// </summary>
+	double costStep = 1;
+
+	/// <summary>
+	/// the biggest difference betwean original and stored cost of edge
+	/// </summary>
+	double maxQuantisationError = 0;
+};
+
+template<typename Cost_t>
+CompressedGraph<Cost_t>::CompressedGraph(const FlatGraph<Cost_t>& graph, unsigned int weightBits)
+	:edgeOffsets(static_cast<size_t>(graph.getNodeCount()) + 1, 0), idOffsets(graph.getNodeCount() + 1, 0),
+	weightBits(weightBits == 0 ? defaultWeightBits(graph) : min(weightBits, 32u))
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	auto edgeCount = graph.getEdgeCount();
+	auto maxLevel = (uint64_t(1) << this->weightBits) - 1;
+
+	if (edgeCount > 0) {
+		auto [itMin, itMax] = minmax_element(graph.getCosts().begin(), graph.getCosts().end());
+		minCost = static_cast<double>(*itMin);
+		auto range = static_cast<double>(*itMax) - minCost;
+
+		costStep = range / maxLevel;
+		//integral costs with small range are stored exactly
+		if (is_integral<Cost_t>::value) {
+			costStep = max(1.0, ceil(costStep));
+		}
+		if (costStep <= 0) {
+			costStep = 1;
+		}
+	}
+
+	ids.reserve(edgeCount);
+	weights.assign((edgeCount * this->weightBits + 63) / 64 + 1, 0);
+
+	vector<tuple<id_t, Cost_t>> sortedNeighbours;
+	size_t edge = 0;
+
+	for (id_t id = 0; id < graph.getNodeCount(); id++) {
+
+		sortedNeighbours.clear();
+		graph.forEachNeighbour(id, [&sortedNeighbours](id_t neigbourId, Cost_t cost) {
+			sortedNeighbours.push_back(tuple<id_t, Cost_t>(neigbourId, cost));
+		});
+		sort(sortedNeighbours.begin(), sortedNeighbours.end());
+
+		idOffsets[id] = ids.size();
+		auto previousId = id;
+		bool first = true;
+
+		for (const auto& [neigbourId, cost] : sortedNeighbours) {
+
+			if (first) {
+				auto difference = static_cast<int64_t>(neigbourId) - static_cast<int64_t>(id);
+				writeVarint(difference < 0 ? (uint64_t(-difference) << 1) - 1 : uint64_t(difference) << 1);
+				first = false;
+			}
+			else {
+				writeVarint(neigbourId - previousId);
+			}
+			previousId = neigbourId;
+
+			auto level = min<uint64_t>(maxLevel, llround((static_cast<double>(cost) - minCost) / costStep));
+			auto bit = edge * this->weightBits;
+			weights[bit / 64] |= level << (bit % 64);
+			if (bit % 64 + this->weightBits > 64) {
+				weights[bit / 64 + 1] |= level >> (64 - bit % 64);
+			}
+
+			maxQuantisationError = max(maxQuantisationError,
+				abs(static_cast<double>(decodeCost(edge)) - static_cast<double>(cost)));
+			edge++;
+		}
+
+		edgeOffsets[id + 1] = edge;
+	}
+
+	idOffsets.back() = ids.size();
+	ids.shrink_to_fit();
+
+	//default bits are lossless for integral costs unless their range needs more than 32 bits
+	assert(weightBits != 0 || !is_integral<Cost_t>::value || maxQuantisationError == 0);
+}
+
+template<typename Cost_t>
+inline unsigned int CompressedGraph<Cost_t>::defaultWeightBits(const FlatGraph<Cost_t>& graph)
+{
+	if constexpr (is_integral<Cost_t>::value) {
+		if (graph.getEdgeCount() == 0) {
+			return 1;
+		}
+
+		auto [itMin, itMax] = minmax_element(graph.getCosts().begin(), graph.getCosts().end());
+		//difference is computed modulo 2^64, so it is right also for signed costs
+		auto range = static_cast<uint64_t>(*itMax) - static_cast<uint64_t>(*itMin);
+
+		unsigned int bits = 1;
+		while (bits < 32 && (range >> bits) != 0) {
+			bits++;
+		}
+		return bits;
+	}
+	else {
+		return 8;
+	}
+}
+
+template<typename Cost_t>
+inline size_t CompressedGraph<Cost_t>::getMemorySize() const
+{
+	return sizeof(*this) + edgeOffsets.capacity() * sizeof(size_t) + idOffsets.capacity() * sizeof(size_t)
+		+ ids.capacity() + weights.capacity() * sizeof(uint64_t);
+}
+
+template<typename Cost_t>
+template<typename Func_t>
+inline void CompressedGraph<Cost_t>::forEachNeighbour(id_t id, Func_t&& func) const
+{
+	NeighbourDecoder decoder(*this, id);
+	id_t neigbourId;
+	Cost_t cost;
+
+	while (decoder.next(neigbourId, cost)) {
+		func(neigbourId, cost);
+	}
+}
+
+template<typename Cost_t>
+inline void CompressedGraph<Cost_t>::writeVarint(uint64_t value)
+{
+	while (value >= 0x80) {
+		ids.push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	ids.push_back(static_cast<uint8_t>(value));
+}
+
+template<typename Cost_t>
+inline Cost_t CompressedGraph<Cost_t>::decodeCost(size_t edge) const
+{
+	auto bit = edge * weightBits;
+	auto level = weights[bit / 64] >> (bit % 64);
+	if (bit % 64 + weightBits > 64) {
+		level |= weights[bit / 64 + 1] << (64 - bit % 64);
+	}
+	level &= (uint64_t(1) << weightBits) - 1;
+
+	auto cost = minCost + level * costStep;
+
+	if constexpr (is_integral<Cost_t>::value) {
+		return static_cast<Cost_t>(llround(cost));
+	}
+	else {
+		return static_cast<Cost_t>(cost);
+	}
+}
+
+template<typename Cost_t>
+inline CompressedGraph<Cost_t>::NeighbourDecoder::NeighbourDecoder(const CompressedGraph& graph, id_t id)
+	:graph(graph), position(graph.ids.data() + graph.idOffsets[id]),
+	edge(graph.edgeOffsets[id]), lastEdge(graph.edgeOffsets[id + 1]), previousId(id)
+{
+}
+
+template<typename Cost_t>
+inline bool CompressedGraph<Cost_t>::NeighbourDecoder::next(id_t& neigbourId, Cost_t& cost)
+{
+	if (edge == lastEdge) {
+		return false;
+	}
+
+	uint64_t value = 0;
+	for (unsigned int shift = 0; ; shift += 7) {
+		auto byte = *position++;
+		value |= uint64_t(byte & 0x7f) << shift;
+		if ((byte & 0x80) == 0) {
+			break;
+		}
+	}
+
+	if (first) {
+		//zigzag encoded difference from id of node
+		auto difference = (value & 1) != 0 ? -static_cast<int64_t>((value + 1) >> 1) : static_cast<int64_t>(value >> 1);
+		previousId = static_cast<id_t>(static_cast<int64_t>(previousId) + difference);
+		first = false;
+	}
+	else {
+		previousId += static_cast<id_t>(value);
+	}
+
+	neigbourId = previousId;
+	cost = graph.decodeCost(edge);
+	edge++;
+
+	return true;
+}
@@ -0,0 +1,47 @@
+#include "pch.h"
+#include "ConcurrentUnionFind.h"
+
+ConcurrentUnionFind::ConcurrentUnionFind(id_t size) :parents(size)
+{
+	for (id_t id = 0; id < size; id++) {
+		parents[id].store(id, memory_order_relaxed);
+	}
+}
+
+id_t ConcurrentUnionFind::find(id_t id)
+{
+	auto parent = parents[id].load();
+
+	while (parent != id) {
+		auto grandParent = parents[parent].load();
+
+		//other thread can change the parent, then the node is only not shortened
+		parents[id].compare_exchange_weak(parent, grandParent);
+
+		id = parent;
+		parent = parents[id].load();
+	}
+
+	return id;
+}
+
+bool ConcurrentUnionFind::unite(id_t first, id_t second)
+{
+	while (true) {
+		first = find(first);
+		second = find(second);
+
+		if (first == second) {
+			return false;
+		}
+		if (first < second) {
+			swap(first, second);
+		}
+
+		//root can be linked by other thread in the meantime
+		auto expected = first;
+		if (parents[first].compare_exchange_strong(expected, second)) {
+			return true;
+		}
+	}
+}
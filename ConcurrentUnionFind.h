@@ -0,0 +1,45 @@
+#pragma once
+
+/// <summary>
+/// disjoint sets of nodes which can be found and joined from many threads without locks
+/// </summary>
+/// <remarks>
+/// root with bigger id is linked under root with smaller id by compare and swap,
+/// find shortens paths by path halving
+/// </remarks>
+class ConcurrentUnionFind
+{
+public:
+	/// <summary>
+	/// creates sets with one node
+	/// </summary>
+	/// <param name="size">number of nodes</param>
+	ConcurrentUnionFind(id_t size);
+
+	/// <summary>
+	/// finds root of set of node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>id of root</returns>
+	id_t find(id_t id);
+
+	/// <summary>
+	/// joins sets of two nodes
+	/// </summary>
+	/// <param name="first">id of node</param>
+	/// <param name="second">id of node</param>
+	/// <returns>false if nodes were already in the same set</returns>
+	bool unite(id_t first, id_t second);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of nodes</returns>
+	id_t getSize() const { return static_cast<id_t>(parents.size()); }
+
+private:
+	/// <summary>
+	/// parent of every node, root is its own parent
+	/// </summary>
+	vector<atomic<id_t>> parents;
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include "FlatGraph.h"
+
+/// <summary>
+/// converts costs of flat graph to other cost type, usually floating point costs to fixed point costs
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <typeparm name="Target_t">new type of cost, it must be constructible from double</typeparm>
+/// <typeparm name="Source_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: graph with converted costs and the biggest difference betwean original and converted cost of edge</returns>
+template <typename Target_t, typename Source_t>
+tuple<FlatGraph<Target_t>, double> quantiseCosts(const FlatGraph<Source_t>& graph)
+{
+	static_assert(is_cost_type<Target_t>::value, "type Target_t must be arithmetic or fixed point");
+
+	vector<edge_t<Target_t>> edges;
+	edges.reserve(graph.getEdgeCount());
+	double maxError = 0;
+
+	for (id_t id = 0; id < graph.getNodeCount(); id++) {
+		graph.forEachNeighbour(id, [&edges, &maxError, id](id_t neigbourId, Source_t cost) {
+			auto quantisedCost = static_cast<Target_t>(static_cast<double>(cost));
+
+			maxError = max(maxError, abs(static_cast<double>(quantisedCost) - static_cast<double>(cost)));
+			edges.push_back(edge_t<Target_t>(id, neigbourId, quantisedCost));
+		});
+	}
+
+	return tuple<FlatGraph<Target_t>, double>(FlatGraph<Target_t>(graph.getNodeCount(), edges), maxError);
+}
+
+/// <summary>
+/// converts costs of graph made of nodes to other cost type, usually floating point costs to fixed point costs
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <typeparm name="Target_t">new type of cost, it must be constructible from double</typeparm>
+/// <typeparm name="Source_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: graph with converted costs and the biggest difference betwean original and converted cost of edge</returns>
+template <typename Target_t, typename Source_t>
+tuple<vector<shared_ptr<NodeInPath<Target_t>>>, double> quantiseCosts(const vector<shared_ptr<NodeInPath<Source_t>>>& graph)
+{
+	static_assert(is_cost_type<Target_t>::value, "type Target_t must be arithmetic or fixed point");
+
+	vector<shared_ptr<NodeInPath<Target_t>>> quantisedGraph(graph.size());
+	double maxError = 0;
+
+	for (id_t id = 0; id < graph.size(); id++) {
+		quantisedGraph[id] = make_shared<NodeInPath<Target_t>>(id);
+	}
+
+	for (id_t id = 0; id < graph.size(); id++) {
+		const auto& neighbours = graph[id]->getNeighbours();
+		quantisedGraph[id]->reserveNeighbours(neighbours.size());
+
+		for (const auto& [weakNeighbour, cost] : neighbours) {
+			auto neighbour = weakNeighbour.lock();
+			if (neighbour == nullptr) {
+				continue;
+			}
+
+			auto quantisedCost = static_cast<Target_t>(static_cast<double>(cost));
+
+			maxError = max(maxError, abs(static_cast<double>(quantisedCost) - static_cast<double>(cost)));
+			quantisedGraph[id]->addNeighbour(quantisedGraph[neighbour->getId()], quantisedCost);
+		}
+	}
+
+	return tuple<vector<shared_ptr<NodeInPath<Target_t>>>, double>(quantisedGraph, maxError);
+}
@@ -26,6 +26,13 @@ public:
 	/// <returns>is set empty</returns>
 	bool isEmpty();
 
+	/// <summary>
+	/// whether any not processed node has computed cost,
+	/// if not the rest of nodes is not reachable
+	/// </summary>
+	/// <returns>is there node which can be poped</returns>
+	bool hasReachableNodes();
+
 	/// <summary>
 	/// set new cost of node
 	/// </summary>
@@ -73,6 +80,13 @@ inline bool DijskstraSet<Cost_t>::isEmpty()
 {
 	return ids.empty();
 }
+
+template<typename Cost_t>
+inline bool DijskstraSet<Cost_t>::hasReachableNodes()
+{
+	return !idWithValue.empty();
+}
+
 template<typename Cost_t>
 inline void DijskstraSet<Cost_t>::setCost(id_t id, Cost_t cost)
 {
@@ -0,0 +1,163 @@
+#pragma once
+
+/// <summary>
+/// fixed point cost: integral raw value which represents raw / Scale,
+/// addition saturates, so max value works as infinite cost
+/// </summary>
+/// <typeparm name="Raw_t">integral type of stored value</typeparm>
+/// <typeparm name="Scale">number of raw units in one unit of cost</typeparm>
+/// <remarks>Fixed&lt;uint32_t, 1000&gt; stores seconds with milliseconds in half of memory of double</remarks>
+template <typename Raw_t, unsigned int Scale>
+class Fixed
+{
+	static_assert(is_integral<Raw_t>::value, "type Raw_t must be integral");
+	static_assert(Scale > 0, "scale must be positive");
+
+public:
+	using raw_type = Raw_t;
+
+	static constexpr unsigned int scale = Scale;
+
+	constexpr Fixed() = default;
+
+	/// <summary>
+	/// cost of whole units, out of range values are saturated
+	/// </summary>
+	/// <param name="value">number of units</param>
+	template <typename Int_t, typename enable_if<is_integral<Int_t>::value, int>::type = 0>
+	constexpr Fixed(Int_t value) :raw(saturate(static_cast<long double>(value) * Scale)) {}
+
+	/// <summary>
+	/// cost rounded to the nearest raw value, out of range values are saturated
+	/// </summary>
+	/// <param name="value">number of units</param>
+	explicit Fixed(double value) :raw(saturate(round(static_cast<long double>(value) * Scale))) {}
+
+	/// <summary>
+	/// creates cost from stored value
+	/// </summary>
+	/// <param name="raw">number of raw units</param>
+	/// <returns>new cost</returns>
+	static constexpr Fixed fromRaw(Raw_t raw)
+	{
+		Fixed cost;
+		cost.raw = raw;
+		return cost;
+	}
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>stored value</returns>
+	constexpr Raw_t getRaw() const { return raw; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>cost as floating point number</returns>
+	explicit constexpr operator double() const { return static_cast<double>(raw) / Scale; }
+
+	/// <summary>
+	/// saturating addition, if one of costs is max value the result is max value
+	/// </summary>
+	friend constexpr Fixed operator+(Fixed left, Fixed right)
+	{
+		constexpr auto maxRaw = numeric_limits<Raw_t>::max();
+		constexpr auto minRaw = numeric_limits<Raw_t>::lowest();
+
+		if (left.raw == maxRaw || right.raw == maxRaw) {
+			return fromRaw(maxRaw);
+		}
+		if (right.raw > 0 && left.raw > maxRaw - right.raw) {
+			return fromRaw(maxRaw);
+		}
+		if constexpr (is_signed<Raw_t>::value) {
+			if (right.raw < 0 && left.raw < minRaw - right.raw) {
+				return fromRaw(minRaw);
+			}
+		}
+		return fromRaw(static_cast<Raw_t>(left.raw + right.raw));
+	}
+
+	/// <summary>
+	/// saturating subtraction
+	/// </summary>
+	friend constexpr Fixed operator-(Fixed left, Fixed right)
+	{
+		constexpr auto maxRaw = numeric_limits<Raw_t>::max();
+		constexpr auto minRaw = numeric_limits<Raw_t>::lowest();
+
+		if (left.raw == maxRaw) {
+			return left;
+		}
+		if (right.raw > 0 && left.raw < minRaw + right.raw) {
+			return fromRaw(minRaw);
+		}
+		if constexpr (is_signed<Raw_t>::value) {
+			if (right.raw < 0 && left.raw > maxRaw + right.raw) {
+				return fromRaw(maxRaw);
+			}
+		}
+		return fromRaw(static_cast<Raw_t>(left.raw - right.raw));
+	}
+
+	Fixed& operator+=(Fixed other) { return *this = *this + other; }
+	Fixed& operator-=(Fixed other) { return *this = *this - other; }
+
+	friend constexpr bool operator==(Fixed left, Fixed right) { return left.raw == right.raw; }
+	friend constexpr bool operator!=(Fixed left, Fixed right) { return left.raw != right.raw; }
+	friend constexpr bool operator<(Fixed left, Fixed right) { return left.raw < right.raw; }
+	friend constexpr bool operator>(Fixed left, Fixed right) { return left.raw > right.raw; }
+	friend constexpr bool operator<=(Fixed left, Fixed right) { return left.raw <= right.raw; }
+	friend constexpr bool operator>=(Fixed left, Fixed right) { return left.raw >= right.raw; }
+
+private:
+	/// <summary>
+	/// clamps value to range of raw type
+	/// </summary>
+	static constexpr Raw_t saturate(long double value)
+	{
+		if (value >= static_cast<long double>(numeric_limits<Raw_t>::max())) {
+			return numeric_limits<Raw_t>::max();
+		}
+		if (value <= static_cast<long double>(numeric_limits<Raw_t>::lowest())) {
+			return numeric_limits<Raw_t>::lowest();
+		}
+		return static_cast<Raw_t>(value);
+	}
+
+	/// <summary>
+	/// number of raw units
+	/// </summary>
+	Raw_t raw = 0;
+};
+
+/// <summary>
+/// limits of fixed point cost, max value is used as infinite cost
+/// </summary>
+namespace std {
+	template <typename Raw_t, unsigned int Scale>
+	class numeric_limits<Fixed<Raw_t, Scale>>
+	{
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = numeric_limits<Raw_t>::is_signed;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = true;
+		static constexpr bool has_infinity = false;
+
+		static constexpr Fixed<Raw_t, Scale> min() noexcept { return Fixed<Raw_t, Scale>::fromRaw(numeric_limits<Raw_t>::min()); }
+		static constexpr Fixed<Raw_t, Scale> max() noexcept { return Fixed<Raw_t, Scale>::fromRaw(numeric_limits<Raw_t>::max()); }
+		static constexpr Fixed<Raw_t, Scale> lowest() noexcept { return Fixed<Raw_t, Scale>::fromRaw(numeric_limits<Raw_t>::lowest()); }
+		static constexpr Fixed<Raw_t, Scale> epsilon() noexcept { return Fixed<Raw_t, Scale>::fromRaw(1); }
+	};
+}
+
+/// <summary>
+/// types which can be used as cost betwean two nodes: arithmetic types and fixed point costs
+/// </summary>
+template <typename Cost_t>
+struct is_cost_type : is_arithmetic<Cost_t> {};
+
+template <typename Raw_t, unsigned int Scale>
+struct is_cost_type<Fixed<Raw_t, Scale>> : true_type {};
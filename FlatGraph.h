@@ -0,0 +1,190 @@
+#pragma once
+#include "NodeInPath.h"
+
+template <typename Cost_t>
+using edge_t = tuple<id_t, id_t, Cost_t>;
+
+/// <summary>
+/// read only graph where neighbours of all nodes are stored
+/// in contiguous arrays (compressed sparse rows)
+/// </summary>
+/// <typeparm name="Cost_t">type of cost betwean two nodes</typeparm>
+/// <remarks>edges of node id are in range [firstEdge(id), lastEdge(id))</remarks>
+template <typename Cost_t>
+class FlatGraph
+{
+public:
+	using cost_type = Cost_t;
+
+	/// <summary>
+	/// copies graph made of nodes
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	FlatGraph(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph);
+
+	/// <summary>
+	/// creates graph from list of edges
+	/// </summary>
+	/// <param name="size">number of nodes in graph</param>
+	/// <param name="edges">list of edges: from, to, cost</param>
+	FlatGraph(id_t size, const vector<edge_t<Cost_t>>& edges);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of nodes</returns>
+	id_t getNodeCount() const { return static_cast<id_t>(offsets.size() - 1); }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of edges</returns>
+	size_t getEdgeCount() const { return targets.size(); }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>index of first edge of the node</returns>
+	size_t firstEdge(id_t id) const { return offsets[id]; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>index after the last edge of the node</returns>
+	size_t lastEdge(id_t id) const { return offsets[id + 1]; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="edge">index of edge</param>
+	/// <returns>id of neighbour node</returns>
+	id_t getTarget(size_t edge) const { return targets[edge]; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="edge">index of edge</param>
+	/// <returns>cost of the edge</returns>
+	Cost_t getCost(size_t edge) const { return costs[edge]; }
+
+	/// <summary>
+	/// changes cost of edge
+	/// </summary>
+	/// <param name="edge">index of edge</param>
+	/// <param name="cost">new cost</param>
+	void setCost(size_t edge, Cost_t cost) { costs[edge] = cost; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>neighbours of all nodes</returns>
+	const vector<id_t>& getTargets() const { return targets; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>costs of all edges</returns>
+	const vector<Cost_t>& getCosts() const { return costs; }
+
+	/// <summary>
+	/// calls function for every neighbour of node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <param name="func">function called with id of neighbour and cost</param>
+	template <typename Func_t>
+	void forEachNeighbour(id_t id, Func_t&& func) const;
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>graph with all edges in opposite direction</returns>
+	FlatGraph reversed() const;
+
+private:
+	/// <summary>
+	/// index of first edge for every node, the last item is number of edges
+	/// </summary>
+	vector<size_t> offsets;
+
+	/// <summary>
+	/// neighbour of every edge
+	/// </summary>
+	vector<id_t> targets;
+
+	/// <summary>
+	/// cost of every edge
+	/// </summary>
+	vector<Cost_t> costs;
+};
+
+template<typename Cost_t>
+inline FlatGraph<Cost_t>::FlatGraph(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph)
+	:offsets(graph.size() + 1, 0)
+{
+	for (size_t i = 0; i < graph.size(); i++) {
+		offsets[i + 1] = offsets[i] + graph[i]->getNeighbours().size();
+	}
+
+	targets.reserve(offsets.back());
+	costs.reserve(offsets.back());
+
+	for (size_t i = 0; i < graph.size(); i++) {
+		for (const auto& [weakNeighbour, neigbourCost] : graph[i]->getNeighbours()) {
+
+			auto neighbour = weakNeighbour.lock();
+			if (neighbour != nullptr) {
+				targets.push_back(neighbour->getId());
+				costs.push_back(neigbourCost);
+			}
+		}
+		offsets[i + 1] = targets.size();
+	}
+}
+
+template<typename Cost_t>
+inline FlatGraph<Cost_t>::FlatGraph(id_t size, const vector<edge_t<Cost_t>>& edges)
+	:offsets(static_cast<size_t>(size) + 1, 0), targets(edges.size()), costs(edges.size())
+{
+	for (const auto& [from, to, cost] : edges) {
+		assert(from < size && to < size);
+		offsets[from + 1]++;
+	}
+
+	for (size_t i = 0; i < size; i++) {
+		offsets[i + 1] += offsets[i];
+	}
+
+	vector<size_t> nextEdge(offsets.begin(), offsets.end() - 1);
+
+	for (const auto& [from, to, cost] : edges) {
+		auto edge = nextEdge[from]++;
+		targets[edge] = to;
+		costs[edge] = cost;
+	}
+}
+
+template<typename Cost_t>
+template<typename Func_t>
+inline void FlatGraph<Cost_t>::forEachNeighbour(id_t id, Func_t&& func) const
+{
+	for (auto edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+		func(targets[edge], costs[edge]);
+	}
+}
+
+template<typename Cost_t>
+inline FlatGraph<Cost_t> FlatGraph<Cost_t>::reversed() const
+{
+	vector<edge_t<Cost_t>> edges;
+	edges.reserve(targets.size());
+
+	for (id_t id = 0; id < getNodeCount(); id++) {
+		for (auto edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+			edges.push_back(edge_t<Cost_t>(targets[edge], id, costs[edge]));
+		}
+	}
+
+	return FlatGraph(getNodeCount(), edges);
+}
@@ -0,0 +1,202 @@
+#pragma once
+#include "NodeInPath.h"
+
+/// <summary>
+/// builds a graph whose nodes and lists of neighbours
+/// are allocated from a few large memory blocks
+/// </summary>
+/// <typeparm name="Cost_t">type of cost betwean two nodes, it must be trivially destructible</typeparm>
+/// <remarks>
+/// nodes and neighbours are trivially destructible, nothing is destroyed one by one,
+/// so the arena is released in time proportional to number of memory blocks,
+/// when list of neighbours grows it is copied to new place in arena and the old place is not reused,
+/// nodes are read by non-owning views which must not outlive the arena
+/// </remarks>
+template <typename Cost_t>
+class GraphArena
+{
+public:
+	using cost_type = Cost_t;
+
+	/// <summary>
+	/// neighbour of node and cost of edge to it
+	/// </summary>
+	struct Neighbour {
+		id_t id;
+		Cost_t cost;
+	};
+
+	/// <summary>
+	/// non-owning view of node, it is valid until neighbours are added to the node
+	/// and while the arena exists
+	/// </summary>
+	class NodeView
+	{
+	public:
+		NodeView(id_t id, const Neighbour* first, const Neighbour* last)
+			:id(id), first(first), last(last) {}
+
+		/// <summary>
+		///
+		/// </summary>
+		/// <returns>id of node</returns>
+		id_t getId() const { return id; }
+
+		/// <summary>
+		///
+		/// </summary>
+		/// <returns>number of neighbours</returns>
+		size_t size() const { return last - first; }
+
+		const Neighbour* begin() const { return first; }
+		const Neighbour* end() const { return last; }
+
+	private:
+		id_t id;
+		const Neighbour* first;
+		const Neighbour* last;
+	};
+
+	/// <summary>
+	/// creates arena and all nodes of graph
+	/// </summary>
+	/// <param name="size">number of nodes in graph</param>
+	/// <param name="blockSize">size in bytes of the first memory block</param>
+	GraphArena(id_t size, size_t blockSize = 1 << 20);
+
+	GraphArena(const GraphArena&) = delete;
+	GraphArena& operator=(const GraphArena&) = delete;
+
+	/// <summary>
+	/// add a neigbour node to selected node
+	/// </summary>
+	/// <param name="from">id of node</param>
+	/// <param name="to">id of neighbour node</param>
+	/// <param name="pathCost">cost connected with this neigbour</param>
+	void addNeighbour(id_t from, id_t to, Cost_t pathCost);
+
+	/// <summary>
+	/// reserves space for neighbours of selected node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <param name="count">expected number of neighbours</param>
+	void reserveNeighbours(id_t id, size_t count);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of nodes</returns>
+	id_t getNodeCount() const { return nodeCount; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>view of the node, it can be used only while the arena exists</returns>
+	NodeView getNode(id_t id) const;
+
+	/// <summary>
+	/// calls function for every neighbour of node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <param name="func">function called with id of neighbour and cost</param>
+	template <typename Func_t>
+	void forEachNeighbour(id_t id, Func_t&& func) const;
+
+private:
+	static_assert(is_trivially_destructible<Neighbour>::value, "type Cost_t must be trivially destructible");
+
+	/// <summary>
+	/// neighbours of one node stored in arena
+	/// </summary>
+	struct Node {
+		Neighbour* neighbours;
+		size_t count;
+		size_t capacity;
+	};
+
+	/// <summary>
+	/// moves neighbours of node to bigger place in arena
+	/// </summary>
+	/// <param name="node">changed node</param>
+	/// <param name="capacity">new number of neighbours which fit in the place</param>
+	void grow(Node& node, size_t capacity);
+
+	/// <summary>
+	/// memory blocks of the graph
+	/// </summary>
+	pmr::monotonic_buffer_resource resource;
+
+	/// <summary>
+	/// all nodes of graph, allocated in arena
+	/// </summary>
+	Node* nodes;
+
+	/// <summary>
+	/// number of nodes
+	/// </summary>
+	id_t nodeCount;
+};
+
+template<typename Cost_t>
+inline GraphArena<Cost_t>::GraphArena(id_t size, size_t blockSize)
+	:resource(max(blockSize, size * (sizeof(Node) + 4 * sizeof(Neighbour)))), nodeCount(size)
+{
+	nodes = static_cast<Node*>(resource.allocate(max<size_t>(size, 1) * sizeof(Node), alignof(Node)));
+
+	for (id_t i = 0; i < size; i++) {
+		nodes[i] = Node{ nullptr, 0, 0 };
+	}
+}
+
+template<typename Cost_t>
+inline void GraphArena<Cost_t>::addNeighbour(id_t from, id_t to, Cost_t pathCost)
+{
+	assert(from < nodeCount && to < nodeCount);
+
+	auto& node = nodes[from];
+
+	if (node.count == node.capacity) {
+		grow(node, max<size_t>(node.capacity * 2, 4));
+	}
+	node.neighbours[node.count++] = Neighbour{ to, pathCost };
+}
+
+template<typename Cost_t>
+inline void GraphArena<Cost_t>::reserveNeighbours(id_t id, size_t count)
+{
+	assert(id < nodeCount);
+
+	if (count > nodes[id].capacity) {
+		grow(nodes[id], count);
+	}
+}
+
+template<typename Cost_t>
+inline typename GraphArena<Cost_t>::NodeView GraphArena<Cost_t>::getNode(id_t id) const
+{
+	assert(id < nodeCount);
+
+	const auto& node = nodes[id];
+	return NodeView(id, node.neighbours, node.neighbours + node.count);
+}
+
+template<typename Cost_t>
+template<typename Func_t>
+inline void GraphArena<Cost_t>::forEachNeighbour(id_t id, Func_t&& func) const
+{
+	for (const auto& neighbour : getNode(id)) {
+		func(neighbour.id, neighbour.cost);
+	}
+}
+
+template<typename Cost_t>
+inline void GraphArena<Cost_t>::grow(Node& node, size_t capacity)
+{
+	auto neighbours = static_cast<Neighbour*>(resource.allocate(capacity * sizeof(Neighbour), alignof(Neighbour)));
+
+	//old place stays in arena until it is released
+	uninitialized_copy(node.neighbours, node.neighbours + node.count, neighbours);
+	node.neighbours = neighbours;
+	node.capacity = capacity;
+}
@@ -0,0 +1,315 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ThreadPool.h"
+#include "ConcurrentUnionFind.h"
+
+/// <summary>
+/// minimum spanning forest found by parallel Boruvka algorithm,
+/// every edge of graph is used as undirected edge
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// every round finds the lightest edge of every component, joins components
+/// and contracts them: ends of edges are replaced by their components, edges inside components
+/// are removed and only the lightest of parallel edges betwean two components is kept,
+/// edges with the same cost are ordered by index, so the forest is the same for any number of threads
+/// </remarks>
+template <typename Cost_t>
+class MinimumSpanningForest
+{
+public:
+	/// <summary>
+	/// value used for components without lightest edge
+	/// </summary>
+	static constexpr size_t noEdge = numeric_limits<size_t>::max();
+
+	/// <summary>
+	/// finds minimum spanning forest of graph
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="threadPool">optional pool used to process edges and components in parallel</param>
+	MinimumSpanningForest(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool = nullptr);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>edges of forest: from, to, cost</returns>
+	const vector<edge_t<Cost_t>>& getEdges() const { return edges; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>sum of costs of edges of forest</returns>
+	Cost_t getCost() const { return cost; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of rounds of Boruvka algorithm</returns>
+	unsigned int getRoundCount() const { return roundCount; }
+
+private:
+	/// <summary>
+	/// edge betwean two components: the smaller and the bigger component and index of edge in graph
+	/// </summary>
+	using ComponentEdge = tuple<id_t, id_t, size_t>;
+
+	/// <summary>
+	/// compares edges by cost and index
+	/// </summary>
+	bool isLighter(size_t edge, size_t otherEdge) const;
+
+	/// <summary>
+	/// keeps only the lightest edge betwean every two components
+	/// </summary>
+	/// <param name="componentEdges">edges betwean different components, they are sorted by components</param>
+	void removeParallelEdges(vector<ComponentEdge>& componentEdges) const;
+
+	/// <summary>
+	/// stores edge as the lightest edge of component if it is lighter than the current one
+	/// </summary>
+	void offerEdge(id_t component, size_t edge);
+
+	/// <summary>
+	/// splits range to tasks and waits for them
+	/// </summary>
+	/// <param name="count">size of range</param>
+	/// <param name="func">called with index of task, first and last index of its part of range</param>
+	/// <returns>number of tasks</returns>
+	template <typename Func_t>
+	size_t runInTasks(size_t count, Func_t&& func);
+
+	const FlatGraph<Cost_t>& graph;
+
+	/// <summary>
+	/// pool used to process edges and components, nullptr if current thread is used
+	/// </summary>
+	ThreadPool* threadPool;
+
+	/// <summary>
+	/// first node of every edge
+	/// </summary>
+	vector<id_t> sources;
+
+	/// <summary>
+	/// components of nodes
+	/// </summary>
+	ConcurrentUnionFind components;
+
+	/// <summary>
+	/// index of the lightest edge of every component
+	/// </summary>
+	vector<atomic<size_t>> lightestEdges;
+
+	/// <summary>
+	/// edges of forest
+	/// </summary>
+	vector<edge_t<Cost_t>> edges;
+
+	/// <summary>
+	/// sum of costs of edges of forest
+	/// </summary>
+	Cost_t cost = 0;
+
+	/// <summary>
+	/// number of rounds
+	/// </summary>
+	unsigned int roundCount = 0;
+};
+
+template<typename Cost_t>
+inline MinimumSpanningForest<Cost_t>::MinimumSpanningForest(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool)
+	:graph(graph), threadPool(threadPool), sources(graph.getEdgeCount()),
+	components(graph.getNodeCount()), lightestEdges(graph.getNodeCount())
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	auto size = graph.getNodeCount();
+
+	for (id_t id = 0; id < size; id++) {
+		lightestEdges[id].store(noEdge, memory_order_relaxed);
+		for (auto edge = graph.firstEdge(id); edge < graph.lastEdge(id); edge++) {
+			sources[edge] = id;
+		}
+	}
+
+	//edges betwean different components, self loops are never used
+	vector<ComponentEdge> activeEdges;
+	activeEdges.reserve(graph.getEdgeCount());
+	for (size_t edge = 0; edge < graph.getEdgeCount(); edge++) {
+		auto target = graph.getTarget(edge);
+		if (sources[edge] != target) {
+			activeEdges.push_back(ComponentEdge(min(sources[edge], target), max(sources[edge], target), edge));
+		}
+	}
+	removeParallelEdges(activeEdges);
+
+	vector<ComponentEdge> nextActiveEdges;
+	vector<vector<edge_t<Cost_t>>> taskEdges;
+	vector<size_t> keptCounts;
+
+	while (!activeEdges.empty()) {
+		roundCount++;
+
+		//the lightest edge of every component, ends of active edges are components
+		runInTasks(activeEdges.size(), [this, &activeEdges](size_t, size_t first, size_t last) {
+			for (auto i = first; i < last; i++) {
+				const auto& [fromComponent, toComponent, edge] = activeEdges[i];
+				offerEdge(fromComponent, edge);
+				offerEdge(toComponent, edge);
+			}
+		});
+
+		//components are joined by their lightest edges
+		taskEdges.assign(threadPool == nullptr ? 1 : threadPool->getThreadCount() * 4, vector<edge_t<Cost_t>>());
+		runInTasks(size, [this, &taskEdges](size_t task, size_t first, size_t last) {
+			for (auto component = static_cast<id_t>(first); component < last; component++) {
+				auto edge = lightestEdges[component].load(memory_order_relaxed);
+				if (edge == noEdge) {
+					continue;
+				}
+				lightestEdges[component].store(noEdge, memory_order_relaxed);
+
+				//the same edge can be the lightest edge of both components
+				if (components.unite(sources[edge], this->graph.getTarget(edge))) {
+					taskEdges[task].push_back(edge_t<Cost_t>(sources[edge], this->graph.getTarget(edge), this->graph.getCost(edge)));
+				}
+			}
+		});
+
+		for (const auto& added : taskEdges) {
+			for (const auto& edge : added) {
+				cost += get<2>(edge);
+			}
+			edges.insert(edges.end(), added.begin(), added.end());
+		}
+
+		//components are contracted, every task relabels and compacts its part in place
+		keptCounts.assign(taskEdges.size(), 0);
+		auto taskCount = runInTasks(activeEdges.size(), [this, &activeEdges, &keptCounts](size_t task, size_t first, size_t last) {
+			auto kept = first;
+			for (auto i = first; i < last; i++) {
+				auto fromComponent = components.find(get<0>(activeEdges[i]));
+				auto toComponent = components.find(get<1>(activeEdges[i]));
+
+				if (fromComponent != toComponent) {
+					activeEdges[kept++] = ComponentEdge(min(fromComponent, toComponent), max(fromComponent, toComponent), get<2>(activeEdges[i]));
+				}
+			}
+			keptCounts[task] = kept - first;
+		});
+
+		size_t keptCount = 0;
+		vector<size_t> keptOffsets(taskCount);
+		for (size_t task = 0; task < taskCount; task++) {
+			keptOffsets[task] = keptCount;
+			keptCount += keptCounts[task];
+		}
+
+		nextActiveEdges.resize(keptCount);
+		runInTasks(activeEdges.size(), [&activeEdges, &nextActiveEdges, &keptCounts, &keptOffsets](size_t task, size_t first, size_t) {
+			copy(activeEdges.begin() + first, activeEdges.begin() + first + keptCounts[task], nextActiveEdges.begin() + keptOffsets[task]);
+		});
+
+		activeEdges.swap(nextActiveEdges);
+		removeParallelEdges(activeEdges);
+	}
+}
+
+template<typename Cost_t>
+inline bool MinimumSpanningForest<Cost_t>::isLighter(size_t edge, size_t otherEdge) const
+{
+	auto edgeCost = graph.getCost(edge);
+	auto otherCost = graph.getCost(otherEdge);
+
+	return edgeCost < otherCost || (!(otherCost < edgeCost) && edge < otherEdge);
+}
+
+template<typename Cost_t>
+inline void MinimumSpanningForest<Cost_t>::removeParallelEdges(vector<ComponentEdge>& componentEdges) const
+{
+	sort(componentEdges.begin(), componentEdges.end(), [this](const ComponentEdge& edge, const ComponentEdge& otherEdge) {
+		if (get<0>(edge) != get<0>(otherEdge) || get<1>(edge) != get<1>(otherEdge)) {
+			return tie(get<0>(edge), get<1>(edge)) < tie(get<0>(otherEdge), get<1>(otherEdge));
+		}
+		return isLighter(get<2>(edge), get<2>(otherEdge));
+	});
+
+	//the first edge of every pair of components is the lightest one
+	componentEdges.erase(unique(componentEdges.begin(), componentEdges.end(), [](const ComponentEdge& edge, const ComponentEdge& otherEdge) {
+		return get<0>(edge) == get<0>(otherEdge) && get<1>(edge) == get<1>(otherEdge);
+	}), componentEdges.end());
+}
+
+template<typename Cost_t>
+inline void MinimumSpanningForest<Cost_t>::offerEdge(id_t component, size_t edge)
+{
+	auto current = lightestEdges[component].load(memory_order_relaxed);
+
+	while (current == noEdge || isLighter(edge, current)) {
+		if (lightestEdges[component].compare_exchange_weak(current, edge, memory_order_relaxed)) {
+			return;
+		}
+	}
+}
+
+template<typename Cost_t>
+template<typename Func_t>
+inline size_t MinimumSpanningForest<Cost_t>::runInTasks(size_t count, Func_t&& func)
+{
+	//ranges smaller than this are not worth a task
+	const size_t minItemsInTask = 1 << 14;
+
+	size_t taskCount = threadPool == nullptr ? 1 :
+		max<size_t>(1, min(threadPool->getThreadCount() * 4, count / minItemsInTask));
+
+	if (taskCount == 1) {
+		func(0, 0, count);
+		return 1;
+	}
+
+	deque<future<void>> pendingTasks;
+
+	for (size_t i = 0; i < taskCount; i++) {
+		auto first = count * i / taskCount;
+		auto last = count * (i + 1) / taskCount;
+
+		pendingTasks.push_back(threadPool->submit([&func, i, first, last]() {
+			func(i, first, last);
+			}));
+	}
+
+	for (const auto& task : pendingTasks) {
+		task.wait();
+	}
+
+	return taskCount;
+}
+
+/// <summary>
+/// finds minimum spanning forest using parallel Boruvka algorithm
+/// </summary>
+/// <param name="graph">definition of graph, edges are used as undirected</param>
+/// <param name="threadPool">optional pool used to process edges in parallel</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: edges of forest and sum of their costs</returns>
+template <typename Cost_t>
+auto minimumSpanningForest(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool = nullptr)
+{
+	MinimumSpanningForest<Cost_t> forest(graph, threadPool);
+
+	return tuple<vector<edge_t<Cost_t>>, Cost_t>(forest.getEdges(), forest.getCost());
+}
+
+/// <summary>
+/// finds minimum spanning forest of graph made of nodes using parallel Boruvka algorithm
+/// </summary>
+/// <param name="graph">definition of graph, edges are used as undirected</param>
+/// <param name="threadPool">optional pool used to process edges in parallel</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: edges of forest and sum of their costs</returns>
+template <typename Cost_t>
+auto minimumSpanningForest(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, ThreadPool* threadPool = nullptr)
+{
+	return minimumSpanningForest(FlatGraph<Cost_t>(graph), threadPool);
+}
@@ -1,4 +1,5 @@
 #pragma once
+#include "FixedCost.h"
 
 /// <summary>
 /// data class describing a node
@@ -14,7 +15,9 @@ public:
 	/// initialize new node
 	/// </summary>
 	/// <param name="id">id of node</param>
-	NodeInPath(id_t id) :id(id) {}
+	/// <param name="resource">memory resource used by the list of neighbours</param>
+	NodeInPath(id_t id, pmr::memory_resource* resource = pmr::get_default_resource())
+		:id(id), neighbours(resource) {}
 
 	/// <summary>
 	/// 
@@ -28,12 +31,32 @@ public:
 	/// <param name="node">neighbour node</param>
 	/// <param name="pathCost">cost connected with this neigbour</param>
 	void addNeighbour(shared_ptr<NodeInPath<Cost_t>> node, Cost_t pathCost);
+
+	/// <summary>
+	/// reserves space for neighbours, so the list does not grow 
+	/// during adding of neighbours
+	/// </summary>
+	/// <param name="count">expected number of neighbours</param>
+	void reserveNeighbours(size_t count);
+
+	/// <summary>
+	/// sets counter of graph changes, it is increased 
+	/// every time when the node is changed
+	/// </summary>
+	/// <param name="counter">counter shared by all nodes of graph</param>
+	void setVersionCounter(shared_ptr<atomic_ullong> counter);
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>counter of graph changes, nullptr if not set</returns>
+	shared_ptr<atomic_ullong> getVersionCounter() { return versionCounter; }
 	
 	/// <summary>
 	/// 
 	/// </summary>
 	/// <returns>all neigbours of this node</returns>
-	const vector<NodeWithCost>& getNeighbours(){return neighbours;}
+	const pmr::vector<NodeWithCost>& getNeighbours(){return neighbours;}
 	
 private:
 	/// <summary>
@@ -44,7 +67,12 @@ private:
 	/// <summary>
 	/// all neighbours, and cost related to them
 	/// </summary>
-	vector<NodeWithCost> neighbours;
+	pmr::vector<NodeWithCost> neighbours;
+
+	/// <summary>
+	/// counter of graph changes
+	/// </summary>
+	shared_ptr<atomic_ullong> versionCounter;
 };
 
 template<typename Cost_t>
@@ -57,4 +85,20 @@ template<typename Cost_t>
 inline void NodeInPath<Cost_t>::addNeighbour(shared_ptr<NodeInPath<Cost_t>> node, Cost_t pathCost)
 {
 	neighbours.push_back(NodeWithCost(node, pathCost));
+
+	if (versionCounter != nullptr) {
+		(*versionCounter)++;
+	}
+}
+
+template<typename Cost_t>
+inline void NodeInPath<Cost_t>::reserveNeighbours(size_t count)
+{
+	neighbours.reserve(count);
+}
+
+template<typename Cost_t>
+inline void NodeInPath<Cost_t>::setVersionCounter(shared_ptr<atomic_ullong> counter)
+{
+	versionCounter = counter;
 }
\ No newline at end of file
@@ -0,0 +1,475 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ThreadPool.h"
+
+/// <summary>
+/// graph split into cells with overlay of boundary nodes,
+/// shortest paths betwean boundary nodes of every cell are precomputed (cliques)
+/// so query searches only start cell, end cell and the overlay
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// after changes of costs only cells with changed edges are customized again,
+/// setCost and customize must not be called during queries,
+/// overlay has only one level: query searches start and end cell edge by edge
+/// and every other cell by its clique, so cells must be small enough for fast local searches,
+/// but with many cells the overlay itself is large, for very big graphs query time
+/// grows with the number of boundary nodes visited on the overlay
+/// </remarks>
+template <typename Cost_t>
+class PartitionOverlay
+{
+public:
+	/// <summary>
+	/// value used for nodes which are not boundary nodes
+	/// </summary>
+	static constexpr id_t noNode = numeric_limits<id_t>::max();
+
+	/// <summary>
+	/// partitions graph and customizes all cells
+	/// </summary>
+	/// <param name="graph">definition of graph, costs must not be negative</param>
+	/// <param name="maxCellSize">max number of nodes in one cell</param>
+	/// <param name="threadPool">pool used to customize cells in parallel</param>
+	PartitionOverlay(const FlatGraph<Cost_t>& graph, id_t maxCellSize, ThreadPool& threadPool);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of cells</returns>
+	id_t getCellCount() const { return static_cast<id_t>(cellNodes.size()); }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>cell of the node</returns>
+	id_t getCell(id_t id) const { return cells[id]; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="cell">id of cell</param>
+	/// <returns>nodes of cell with edges to other cells</returns>
+	const vector<id_t>& getBoundaryNodes(id_t cell) const { return boundaryNodes[cell]; }
+
+	/// <summary>
+	/// changes cost of edge, the cell of edge is customized
+	/// during next call of customize
+	/// </summary>
+	/// <param name="from">id of node</param>
+	/// <param name="to">id of neighbour node</param>
+	/// <param name="cost">new cost</param>
+	/// <returns>false if there is no such edge</returns>
+	bool setCost(id_t from, id_t to, Cost_t cost);
+
+	/// <summary>
+	/// computes cliques of cells with changed costs
+	/// </summary>
+	void customize();
+
+	/// <summary>
+	/// finds shortest path using overlay
+	/// </summary>
+	/// <param name="startNodeId">starting node</param>
+	/// <param name="endNodeId">last node in searching path</param>
+	/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+	tuple<deque<id_t>, Cost_t> shortestPath(id_t startNodeId, id_t endNodeId) const;
+
+private:
+	using CostAndId = tuple<Cost_t, id_t>;
+	using MinQueue = priority_queue<CostAndId, vector<CostAndId>, greater<CostAndId>>;
+
+	/// <summary>
+	/// splits nodes into cells using label propagation
+	/// </summary>
+	/// <param name="maxCellSize">max number of nodes in one cell</param>
+	void partition(id_t maxCellSize);
+
+	/// <summary>
+	/// finds nodes with edges to other cells
+	/// </summary>
+	void findBoundaryNodes();
+
+	/// <summary>
+	/// computes clique of one cell
+	/// </summary>
+	/// <param name="cell">id of cell</param>
+	void customizeCell(id_t cell);
+
+	/// <summary>
+	/// dijstra search which uses only edges inside cell
+	/// </summary>
+	/// <param name="cell">id of cell</param>
+	/// <param name="startNodeId">starting node, it must be in the cell</param>
+	/// <param name="localCosts">cost of every node of cell, indexed by localIds</param>
+	/// <param name="localPrevNodes">previous node in path, indexed by localIds</param>
+	void localSearch(id_t cell, id_t startNodeId, vector<Cost_t>& localCosts, vector<id_t>& localPrevNodes) const;
+
+	/// <summary>
+	/// finds path inside cell
+	/// </summary>
+	/// <param name="cell">id of cell</param>
+	/// <param name="startNodeId">first node of path</param>
+	/// <param name="endNodeId">last node of path</param>
+	/// <returns>list of ids in path</returns>
+	deque<id_t> localPath(id_t cell, id_t startNodeId, id_t endNodeId) const;
+
+	/// <summary>
+	/// definition of graph
+	/// </summary>
+	FlatGraph<Cost_t> graph;
+
+	/// <summary>
+	/// pool used to customize cells
+	/// </summary>
+	ThreadPool& threadPool;
+
+	/// <summary>
+	/// cell of every node
+	/// </summary>
+	vector<id_t> cells;
+
+	/// <summary>
+	/// index of every node in the list of nodes of its cell
+	/// </summary>
+	vector<id_t> localIds;
+
+	/// <summary>
+	/// index of every node in the list of boundary nodes of its cell, noNode if it is not boundary node
+	/// </summary>
+	vector<id_t> boundaryIds;
+
+	/// <summary>
+	/// nodes of every cell
+	/// </summary>
+	vector<vector<id_t>> cellNodes;
+
+	/// <summary>
+	/// boundary nodes of every cell
+	/// </summary>
+	vector<vector<id_t>> boundaryNodes;
+
+	/// <summary>
+	/// costs betwean boundary nodes of every cell, matrix is stored by rows
+	/// </summary>
+	vector<vector<Cost_t>> cliques;
+
+	/// <summary>
+	/// cells which must be customized
+	/// </summary>
+	vector<bool> dirtyCells;
+};
+
+template<typename Cost_t>
+inline PartitionOverlay<Cost_t>::PartitionOverlay(const FlatGraph<Cost_t>& graph, id_t maxCellSize, ThreadPool& threadPool)
+	:graph(graph), threadPool(threadPool)
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	partition(max(maxCellSize, 1u));
+	findBoundaryNodes();
+
+	cliques.resize(cellNodes.size());
+	dirtyCells.assign(cellNodes.size(), true);
+	customize();
+}
+
+template<typename Cost_t>
+inline bool PartitionOverlay<Cost_t>::setCost(id_t from, id_t to, Cost_t cost)
+{
+	assert(cost >= 0);
+
+	bool found = false;
+
+	for (auto edge = graph.firstEdge(from); edge < graph.lastEdge(from); edge++) {
+		if (graph.getTarget(edge) == to) {
+			graph.setCost(edge, cost);
+			found = true;
+		}
+	}
+
+	//edges betwean cells are not part of cliques
+	if (found && cells[from] == cells[to]) {
+		dirtyCells[cells[from]] = true;
+	}
+
+	return found;
+}
+
+template<typename Cost_t>
+inline void PartitionOverlay<Cost_t>::customize()
+{
+	deque<future<void>> pendingTasks;
+
+	for (id_t cell = 0; cell < getCellCount(); cell++) {
+		if (dirtyCells[cell]) {
+			dirtyCells[cell] = false;
+			pendingTasks.push_back(threadPool.submit([this, cell]() { customizeCell(cell); }));
+		}
+	}
+
+	for (const auto& task : pendingTasks) {
+		task.wait();
+	}
+}
+
+template<typename Cost_t>
+tuple<deque<id_t>, Cost_t> PartitionOverlay<Cost_t>::shortestPath(id_t startNodeId, id_t endNodeId) const
+{
+	auto size = graph.getNodeCount();
+
+	vector<Cost_t> costs(size, numeric_limits<Cost_t>::max());
+	vector<id_t> prevNodes(size, noNode);
+	//was the node reached by clique edge
+	vector<bool> viaClique(size, false);
+
+	auto startCell = cells[startNodeId];
+	auto endCell = cells[endNodeId];
+
+	MinQueue queue;
+	costs[startNodeId] = 0;
+	queue.push(CostAndId(0, startNodeId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		if (costs[processNodeId] < cost) {
+			continue;
+		}
+		if (processNodeId == endNodeId) {
+			break;
+		}
+
+		auto relax = [&, cost = cost, processNodeId = processNodeId](id_t neigbourId, Cost_t neigbourCost, bool clique) {
+			auto newNeigbourCost = cost + neigbourCost;
+			if (costs[neigbourId] > newNeigbourCost) {
+				costs[neigbourId] = newNeigbourCost;
+				prevNodes[neigbourId] = processNodeId;
+				viaClique[neigbourId] = clique;
+				queue.push(CostAndId(newNeigbourCost, neigbourId));
+			}
+		};
+
+		auto cell = cells[processNodeId];
+
+		if (cell == startCell || cell == endCell) {
+			graph.forEachNeighbour(processNodeId, [&relax](id_t neigbourId, Cost_t neigbourCost) {
+				relax(neigbourId, neigbourCost, false);
+			});
+			continue;
+		}
+
+		//other cells are entered only by boundary nodes
+		const auto& boundary = boundaryNodes[cell];
+		const auto& clique = cliques[cell];
+		auto row = boundaryIds[processNodeId] * boundary.size();
+
+		for (size_t i = 0; i < boundary.size(); i++) {
+			if (boundary[i] != processNodeId && clique[row + i] != numeric_limits<Cost_t>::max()) {
+				relax(boundary[i], clique[row + i], true);
+			}
+		}
+
+		graph.forEachNeighbour(processNodeId, [&relax, this, cell](id_t neigbourId, Cost_t neigbourCost) {
+			if (cells[neigbourId] != cell) {
+				relax(neigbourId, neigbourCost, false);
+			}
+		});
+	}
+
+	deque<id_t> path{ endNodeId };
+
+	for (auto id = endNodeId; prevNodes[id] != noNode; id = prevNodes[id]) {
+		auto prevId = prevNodes[id];
+
+		if (viaClique[id]) {
+			auto cellPath = localPath(cells[id], prevId, id);
+			path.insert(path.begin(), cellPath.begin() + 1, cellPath.end() - 1);
+		}
+		path.push_front(prevId);
+	}
+
+	return tuple<deque<id_t>, Cost_t>(path, costs[endNodeId]);
+}
+
+template<typename Cost_t>
+void PartitionOverlay<Cost_t>::partition(id_t maxCellSize)
+{
+	const id_t maxRounds = 16;
+
+	auto size = graph.getNodeCount();
+	auto reversedGraph = graph.reversed();
+
+	vector<id_t> labels(size);
+	vector<id_t> labelSizes(size, 1);
+
+	for (id_t id = 0; id < size; id++) {
+		labels[id] = id;
+	}
+
+	unordered_map<id_t, id_t> labelCounts;
+
+	for (id_t round = 0; round < maxRounds; round++) {
+
+		bool changed = false;
+
+		for (id_t id = 0; id < size; id++) {
+
+			labelCounts.clear();
+
+			auto countLabel = [&labelCounts, &labels](id_t neigbourId, Cost_t) { labelCounts[labels[neigbourId]]++; };
+			graph.forEachNeighbour(id, countLabel);
+			reversedGraph.forEachNeighbour(id, countLabel);
+
+			auto bestLabel = labels[id];
+			auto bestCount = labelCounts[bestLabel];
+
+			for (const auto& [label, count] : labelCounts) {
+				if (count > bestCount && labelSizes[label] < maxCellSize) {
+					bestLabel = label;
+					bestCount = count;
+				}
+			}
+
+			if (bestLabel != labels[id]) {
+				labelSizes[labels[id]]--;
+				labelSizes[bestLabel]++;
+				labels[id] = bestLabel;
+				changed = true;
+			}
+		}
+
+		if (!changed) {
+			break;
+		}
+	}
+
+	//labels are renumbered to consecutive cells
+	vector<id_t> labelCells(size, noNode);
+
+	cells.resize(size);
+	localIds.resize(size);
+
+	for (id_t id = 0; id < size; id++) {
+		auto& cell = labelCells[labels[id]];
+
+		if (cell == noNode) {
+			cell = static_cast<id_t>(cellNodes.size());
+			cellNodes.emplace_back();
+		}
+
+		cells[id] = cell;
+		localIds[id] = static_cast<id_t>(cellNodes[cell].size());
+		cellNodes[cell].push_back(id);
+	}
+}
+
+template<typename Cost_t>
+inline void PartitionOverlay<Cost_t>::findBoundaryNodes()
+{
+	auto size = graph.getNodeCount();
+	vector<bool> isBoundary(size, false);
+
+	for (id_t id = 0; id < size; id++) {
+		graph.forEachNeighbour(id, [&isBoundary, this, id](id_t neigbourId, Cost_t) {
+			if (cells[neigbourId] != cells[id]) {
+				isBoundary[id] = true;
+				isBoundary[neigbourId] = true;
+			}
+		});
+	}
+
+	boundaryIds.assign(size, noNode);
+	boundaryNodes.resize(cellNodes.size());
+
+	for (id_t id = 0; id < size; id++) {
+		if (isBoundary[id]) {
+			auto& boundary = boundaryNodes[cells[id]];
+			boundaryIds[id] = static_cast<id_t>(boundary.size());
+			boundary.push_back(id);
+		}
+	}
+}
+
+template<typename Cost_t>
+inline void PartitionOverlay<Cost_t>::customizeCell(id_t cell)
+{
+	const auto& boundary = boundaryNodes[cell];
+
+	vector<Cost_t> clique(boundary.size() * boundary.size());
+	vector<Cost_t> localCosts;
+	vector<id_t> localPrevNodes;
+
+	for (size_t i = 0; i < boundary.size(); i++) {
+
+		localSearch(cell, boundary[i], localCosts, localPrevNodes);
+
+		for (size_t j = 0; j < boundary.size(); j++) {
+			clique[i * boundary.size() + j] = localCosts[localIds[boundary[j]]];
+		}
+	}
+
+	cliques[cell] = move(clique);
+}
+
+template<typename Cost_t>
+void PartitionOverlay<Cost_t>::localSearch(id_t cell, id_t startNodeId,
+	vector<Cost_t>& localCosts, vector<id_t>& localPrevNodes) const
+{
+	const auto& nodes = cellNodes[cell];
+
+	localCosts.assign(nodes.size(), numeric_limits<Cost_t>::max());
+	localPrevNodes.assign(nodes.size(), noNode);
+
+	MinQueue queue;
+	localCosts[localIds[startNodeId]] = 0;
+	queue.push(CostAndId(0, startNodeId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		if (localCosts[localIds[processNodeId]] < cost) {
+			continue;
+		}
+
+		graph.forEachNeighbour(processNodeId, [&, cost = cost, processNodeId = processNodeId](id_t neigbourId, Cost_t neigbourCost) {
+
+			assert(neigbourCost >= 0);
+
+			if (cells[neigbourId] != cell) {
+				return;
+			}
+
+			auto newNeigbourCost = cost + neigbourCost;
+			auto localId = localIds[neigbourId];
+
+			if (localCosts[localId] > newNeigbourCost) {
+				localCosts[localId] = newNeigbourCost;
+				localPrevNodes[localId] = processNodeId;
+				queue.push(CostAndId(newNeigbourCost, neigbourId));
+			}
+		});
+	}
+}
+
+template<typename Cost_t>
+inline deque<id_t> PartitionOverlay<Cost_t>::localPath(id_t cell, id_t startNodeId, id_t endNodeId) const
+{
+	vector<Cost_t> localCosts;
+	vector<id_t> localPrevNodes;
+
+	localSearch(cell, startNodeId, localCosts, localPrevNodes);
+
+	deque<id_t> path{ endNodeId };
+
+	for (auto id = endNodeId; localPrevNodes[localIds[id]] != noNode; id = localPrevNodes[localIds[id]]) {
+		path.push_front(localPrevNodes[localIds[id]]);
+	}
+
+	return path;
+}
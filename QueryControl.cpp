@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "QueryControl.h"
+
+QueryControl::QueryControl(unsigned int checkInterval)
+	:checkInterval(max(checkInterval, 1u))
+{
+}
+
+QueryControl::QueryControl(chrono::steady_clock::time_point deadline, unsigned int checkInterval)
+	:hasDeadline(true), deadline(deadline), checkInterval(max(checkInterval, 1u))
+{
+}
+
+void QueryControl::cancel()
+{
+	cancelRequested = true;
+}
+
+bool QueryControl::shouldStop()
+{
+	if (status != QueryStatus::running) {
+		return isStopped();
+	}
+
+	if (++relaxations % checkInterval != 0) {
+		return false;
+	}
+
+	return check();
+}
+
+bool QueryControl::check()
+{
+	auto expected = QueryStatus::running;
+
+	if (cancelRequested) {
+		status.compare_exchange_strong(expected, QueryStatus::cancelled);
+	}
+	else if (hasDeadline && chrono::steady_clock::now() >= deadline) {
+		status.compare_exchange_strong(expected, QueryStatus::timedOut);
+	}
+
+	return isStopped();
+}
+
+void QueryControl::finish()
+{
+	auto expected = QueryStatus::running;
+	status.compare_exchange_strong(expected, QueryStatus::completed);
+}
+
+bool QueryControl::isStopped()
+{
+	auto current = status.load();
+	return current == QueryStatus::timedOut || current == QueryStatus::cancelled;
+}
+
+QueryStatus QueryControl::getStatus()
+{
+	return status;
+}
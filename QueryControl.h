@@ -0,0 +1,94 @@
+#pragma once
+
+/// <summary>
+/// state of the query
+/// </summary>
+enum class QueryStatus { running, completed, timedOut, cancelled };
+
+/// <summary>
+/// deadline and cancellation of a running query,
+/// search functions check it every few relaxations
+/// </summary>
+/// <remarks>it is thread safe, cancel can be called from any thread</remarks>
+class QueryControl
+{
+public:
+	/// <summary>
+	/// query without deadline, it can be only cancelled
+	/// </summary>
+	/// <param name="checkInterval">number of relaxations betwean checks of deadline</param>
+	QueryControl(unsigned int checkInterval = 1024);
+
+	/// <summary>
+	/// query which is stopped when deadline is reached
+	/// </summary>
+	/// <param name="deadline">time point when query is stopped</param>
+	/// <param name="checkInterval">number of relaxations betwean checks of deadline</param>
+	QueryControl(chrono::steady_clock::time_point deadline, unsigned int checkInterval = 1024);
+
+	/// <summary>
+	/// requests the query to stop
+	/// </summary>
+	void cancel();
+
+	/// <summary>
+	/// counts relaxation, every checkInterval relaxations 
+	/// it checks cancellation and deadline
+	/// </summary>
+	/// <returns>should the search stop</returns>
+	bool shouldStop();
+
+	/// <summary>
+	/// checks cancellation and deadline immediately
+	/// </summary>
+	/// <returns>should the search stop</returns>
+	bool check();
+
+	/// <summary>
+	/// marks query as completed, if it was not stopped
+	/// </summary>
+	void finish();
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>was the query stopped by cancel or deadline</returns>
+	bool isStopped();
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>state of the query</returns>
+	QueryStatus getStatus();
+
+private:
+	/// <summary>
+	/// was cancel called
+	/// </summary>
+	atomic_bool cancelRequested = false;
+
+	/// <summary>
+	/// is deadline set
+	/// </summary>
+	bool hasDeadline = false;
+
+	/// <summary>
+	/// time point when query is stopped
+	/// </summary>
+	chrono::steady_clock::time_point deadline;
+
+	/// <summary>
+	/// number of relaxations betwean checks of deadline
+	/// </summary>
+	unsigned int checkInterval;
+
+	/// <summary>
+	/// number of relaxations done so far
+	/// </summary>
+	atomic_uint relaxations = 0;
+
+	/// <summary>
+	/// state of the query
+	/// </summary>
+	atomic<QueryStatus> status = QueryStatus::running;
+};
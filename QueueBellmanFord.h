@@ -0,0 +1,157 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ShortestPathTree.h"
+#include "QueryControl.h"
+
+/// <summary>
+/// finds shortes path in graph with negative costs using queue based bellman-ford algorithm
+/// with subtree disassembly, negative cycle is detected as soon as it is closed
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node in the path</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque), cost of the path and negative cycle(deque),
+/// the last node of the cycle has edge to the first one; when cycle is found
+/// the path is empty and the cost is the lowest value</returns>
+/// <remarks>
+/// tree of shortest paths is stored as preorder thread (next, previous and depth of every node),
+/// when cost of node decreases its subtree is removed from the tree and its nodes are not scanned
+/// until they are improved again, if the subtree contains the relaxed node the edge closes negative cycle;
+/// search runs in one thread without recursion and uses O(V) memory
+/// </remarks>
+template <typename Cost_t>
+auto queueBellmanFordShortestPath(const FlatGraph<Cost_t>& graph,
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr)
+{
+	static_assert(is_cost_type<Cost_t>::value, "type Cost_t must be arithmetic or fixed point");
+
+	auto size = graph.getNodeCount();
+
+	ShortestPathTree<Cost_t> tree(size, startNodeId);
+	deque<id_t> cycle;
+
+	//preorder thread of the tree, it is circular list which starts with start node
+	vector<id_t> nextNodes(size, ShortestPathTree<Cost_t>::noNode);
+	vector<id_t> previousNodes(size, ShortestPathTree<Cost_t>::noNode);
+	vector<id_t> depths(size, 0);
+	vector<uint8_t> inTree(size, 0);
+
+	//circular queue, every node is in the queue at most once
+	vector<id_t> queue(size);
+	vector<uint8_t> inQueue(size, 0);
+	size_t queueBegin = 0;
+	size_t queueLength = 0;
+
+	tree.costs[startNodeId] = 0;
+	nextNodes[startNodeId] = startNodeId;
+	previousNodes[startNodeId] = startNodeId;
+	inTree[startNodeId] = 1;
+
+	queue[0] = startNodeId;
+	inQueue[startNodeId] = 1;
+	queueLength = 1;
+
+	while (queueLength > 0 && cycle.empty()) {
+
+		auto processNodeId = queue[queueBegin];
+		queueBegin = (queueBegin + 1) % size;
+		queueLength--;
+		inQueue[processNodeId] = 0;
+
+		//cost of ancestor decreased, node will be scanned after it is improved
+		if (inTree[processNodeId] == 0) {
+			continue;
+		}
+
+		auto cost = tree.costs[processNodeId];
+
+		for (auto edge = graph.firstEdge(processNodeId); edge < graph.lastEdge(processNodeId); edge++) {
+
+			if (control != nullptr && control->shouldStop()) {
+				queueLength = 0;
+				break;
+			}
+
+			auto neigbourId = graph.getTarget(edge);
+			auto newNeigbourCost = cost + graph.getCost(edge);
+
+			if (tree.costs[neigbourId] <= newNeigbourCost) {
+				continue;
+			}
+
+			if (inTree[neigbourId] != 0) {
+				//removes subtree of neighbour from the thread
+				auto lastInSubtree = neigbourId;
+				for (auto id = nextNodes[neigbourId]; id != neigbourId && depths[id] > depths[neigbourId]; id = nextNodes[id]) {
+					inTree[id] = 0;
+					lastInSubtree = id;
+				}
+
+				if (neigbourId == processNodeId || inTree[processNodeId] == 0) {
+					//processed node is in the subtree, edge closes negative cycle
+					for (auto id = processNodeId; id != neigbourId; id = tree.prevNodes[id]) {
+						cycle.push_front(id);
+					}
+					cycle.push_front(neigbourId);
+					break;
+				}
+
+				auto previousId = previousNodes[neigbourId];
+				auto followingId = nextNodes[lastInSubtree];
+				nextNodes[previousId] = followingId;
+				previousNodes[followingId] = previousId;
+			}
+
+			tree.costs[neigbourId] = newNeigbourCost;
+			tree.prevNodes[neigbourId] = processNodeId;
+
+			//neighbour is inserted to the thread as the first child of processed node
+			auto followingId = nextNodes[processNodeId];
+			nextNodes[neigbourId] = followingId;
+			previousNodes[followingId] = neigbourId;
+			nextNodes[processNodeId] = neigbourId;
+			previousNodes[neigbourId] = processNodeId;
+			depths[neigbourId] = depths[processNodeId] + 1;
+			inTree[neigbourId] = 1;
+
+			if (inQueue[neigbourId] == 0) {
+				queue[(queueBegin + queueLength) % size] = neigbourId;
+				queueLength++;
+				inQueue[neigbourId] = 1;
+			}
+		}
+	}
+
+	if (control != nullptr) {
+		control->finish();
+	}
+
+	if (!cycle.empty()) {
+		return tuple<deque<id_t>, Cost_t, deque<id_t>>(deque<id_t>(), numeric_limits<Cost_t>::lowest(), cycle);
+	}
+
+	auto path = tree.getPath(endNodeId);
+	auto minCost = tree.getCost(endNodeId);
+
+	return tuple<decltype(path), decltype(minCost), deque<id_t>>(path, minCost, cycle);
+}
+
+/// <summary>
+/// finds shortes path in graph with negative costs using queue based bellman-ford algorithm
+/// with subtree disassembly, negative cycle is detected as soon as it is closed
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node in the path</param>
+/// <param name="endNodeId">last node in searching path</param>
+/// <param name="control">optional deadline and cancellation of the search</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tuple: shortest path(deque), cost of the path and negative cycle(deque)</returns>
+/// <remarks>graph is converted to flat graph, for many queries convert it once</remarks>
+template <typename Cost_t>
+auto queueBellmanFordShortestPath(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	id_t startNodeId, id_t endNodeId, QueryControl* control = nullptr)
+{
+	return queueBellmanFordShortestPath(FlatGraph<Cost_t>(graph), startNodeId, endNodeId, control);
+}
@@ -0,0 +1,343 @@
+#include "pch.h"
+#include "ReachabilityIndex.h"
+
+bool ReachabilityIndex::isUnreachable(id_t startNodeId, id_t endNodeId) const
+{
+	auto startComponent = components[startNodeId];
+	auto endComponent = components[endNodeId];
+
+	if (startComponent == endComponent) {
+		return false;
+	}
+
+	//edges of condensation graph go only forward in topological order
+	if (topologicalOrder[startComponent] > topologicalOrder[endComponent]) {
+		return true;
+	}
+
+	//interval of reachable component is inside interval of start component
+	for (unsigned int label = 0; label < labelCount; label++) {
+		auto start = (static_cast<size_t>(label) * componentCount + startComponent) * 2;
+		auto end = (static_cast<size_t>(label) * componentCount + endComponent) * 2;
+
+		if (intervals[end] < intervals[start] || intervals[end + 1] > intervals[start + 1]) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void ReachabilityIndex::build(ThreadPool* threadPool, unsigned int labelCount)
+{
+	//subproblems smaller than this are solved in one task
+	const size_t minParallelSize = 4096;
+
+	auto size = static_cast<id_t>(offsets.size() - 1);
+
+	reversedOffsets.assign(offsets.size(), 0);
+	reversedTargets.resize(targets.size());
+
+	for (auto target : targets) {
+		reversedOffsets[target + 1]++;
+	}
+	for (id_t id = 0; id < size; id++) {
+		reversedOffsets[id + 1] += reversedOffsets[id];
+	}
+
+	vector<size_t> nextEdge(reversedOffsets.begin(), reversedOffsets.end() - 1);
+	for (id_t id = 0; id < size; id++) {
+		for (auto edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+			reversedTargets[nextEdge[targets[edge]]++] = id;
+		}
+	}
+
+	colors = vector<atomic<id_t>>(size);
+	marks.assign(size, 0);
+	components.assign(size, noNode);
+
+	trim();
+
+	Subproblem rest{ 0, {} };
+	for (id_t id = 0; id < size; id++) {
+		if (components[id] == noNode) {
+			rest.nodes.push_back(id);
+		}
+	}
+
+	if (threadPool == nullptr) {
+		solveSubproblem(move(rest));
+	}
+	else {
+		vector<Subproblem> batch;
+		if (!rest.nodes.empty()) {
+			batch.push_back(move(rest));
+		}
+
+		//subproblems of one batch are disjoint, so they are processed in parallel
+		while (!batch.empty()) {
+			deque<future<vector<Subproblem>>> pendingTasks;
+
+			for (const auto& subproblem : batch) {
+				pendingTasks.push_back(threadPool->submit<vector<Subproblem>>([this, &subproblem]() {
+					if (subproblem.nodes.size() < minParallelSize) {
+						solveSubproblem(subproblem);
+						return vector<Subproblem>();
+					}
+					return splitSubproblem(subproblem);
+					}));
+			}
+
+			vector<Subproblem> nextBatch;
+			for (auto& task : pendingTasks) {
+				for (auto& subproblem : task.get()) {
+					nextBatch.push_back(move(subproblem));
+				}
+			}
+			batch = move(nextBatch);
+		}
+	}
+
+	colors = vector<atomic<id_t>>();
+	marks = vector<uint8_t>();
+
+	labelCondensation(labelCount);
+}
+
+void ReachabilityIndex::trim()
+{
+	auto size = static_cast<id_t>(offsets.size() - 1);
+
+	vector<size_t> inDegrees(size);
+	vector<size_t> outDegrees(size);
+	vector<id_t> trimmed;
+
+	for (id_t id = 0; id < size; id++) {
+		outDegrees[id] = offsets[id + 1] - offsets[id];
+		inDegrees[id] = reversedOffsets[id + 1] - reversedOffsets[id];
+
+		if (outDegrees[id] == 0 || inDegrees[id] == 0) {
+			trimmed.push_back(id);
+		}
+	}
+
+	while (!trimmed.empty()) {
+		auto id = trimmed.back();
+		trimmed.pop_back();
+
+		if (components[id] != noNode) {
+			continue;
+		}
+		components[id] = componentCount++;
+		colors[id].store(noNode, memory_order_relaxed);
+
+		for (auto edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+			if (--inDegrees[targets[edge]] == 0) {
+				trimmed.push_back(targets[edge]);
+			}
+		}
+		for (auto edge = reversedOffsets[id]; edge < reversedOffsets[id + 1]; edge++) {
+			if (--outDegrees[reversedTargets[edge]] == 0) {
+				trimmed.push_back(reversedTargets[edge]);
+			}
+		}
+	}
+}
+
+vector<ReachabilityIndex::Subproblem> ReachabilityIndex::splitSubproblem(const Subproblem& subproblem)
+{
+	const uint8_t forwardFlag = 1;
+	const uint8_t backwardFlag = 2;
+
+	auto pivot = subproblem.nodes.front();
+
+	markReachable(subproblem.color, pivot, true, forwardFlag);
+	markReachable(subproblem.color, pivot, false, backwardFlag);
+
+	auto component = componentCount++;
+
+	vector<Subproblem> parts{
+		Subproblem{ nextColor++, {} },
+		Subproblem{ nextColor++, {} },
+		Subproblem{ nextColor++, {} }
+	};
+
+	for (auto id : subproblem.nodes) {
+		auto mark = marks[id];
+		marks[id] = 0;
+
+		if (mark == (forwardFlag | backwardFlag)) {
+			components[id] = component;
+			colors[id].store(noNode, memory_order_relaxed);
+			continue;
+		}
+
+		//forward set, backward set or the rest
+		auto& part = mark == forwardFlag ? parts[0] : mark == backwardFlag ? parts[1] : parts[2];
+		colors[id].store(part.color, memory_order_relaxed);
+		part.nodes.push_back(id);
+	}
+
+	parts.erase(remove_if(parts.begin(), parts.end(),
+		[](const Subproblem& part) { return part.nodes.empty(); }), parts.end());
+
+	return parts;
+}
+
+void ReachabilityIndex::solveSubproblem(Subproblem subproblem)
+{
+	vector<Subproblem> pending;
+
+	if (!subproblem.nodes.empty()) {
+		pending.push_back(move(subproblem));
+	}
+
+	while (!pending.empty()) {
+		auto current = move(pending.back());
+		pending.pop_back();
+
+		for (auto& part : splitSubproblem(current)) {
+			pending.push_back(move(part));
+		}
+	}
+}
+
+void ReachabilityIndex::markReachable(id_t color, id_t pivot, bool forward, uint8_t flag)
+{
+	const auto& edgeOffsets = forward ? offsets : reversedOffsets;
+	const auto& edgeTargets = forward ? targets : reversedTargets;
+
+	vector<id_t> pending{ pivot };
+	marks[pivot] |= flag;
+
+	while (!pending.empty()) {
+		auto id = pending.back();
+		pending.pop_back();
+
+		for (auto edge = edgeOffsets[id]; edge < edgeOffsets[id + 1]; edge++) {
+			auto neigbourId = edgeTargets[edge];
+
+			//marks of other subproblems are not touched
+			if (colors[neigbourId].load(memory_order_relaxed) == color && (marks[neigbourId] & flag) == 0) {
+				marks[neigbourId] |= flag;
+				pending.push_back(neigbourId);
+			}
+		}
+	}
+}
+
+void ReachabilityIndex::labelCondensation(unsigned int labelCount)
+{
+	this->labelCount = labelCount;
+
+	id_t count = componentCount;
+	auto size = static_cast<id_t>(offsets.size() - 1);
+
+	//edges betwean components without duplicates
+	vector<tuple<id_t, id_t>> componentEdges;
+	for (id_t id = 0; id < size; id++) {
+		for (auto edge = offsets[id]; edge < offsets[id + 1]; edge++) {
+			if (components[id] != components[targets[edge]]) {
+				componentEdges.push_back(tuple<id_t, id_t>(components[id], components[targets[edge]]));
+			}
+		}
+	}
+	sort(componentEdges.begin(), componentEdges.end());
+	componentEdges.erase(unique(componentEdges.begin(), componentEdges.end()), componentEdges.end());
+
+	vector<size_t> dagOffsets(static_cast<size_t>(count) + 1, 0);
+	vector<id_t> dagTargets(componentEdges.size());
+	vector<id_t> inDegrees(count, 0);
+
+	for (size_t i = 0; i < componentEdges.size(); i++) {
+		const auto& [from, to] = componentEdges[i];
+		dagOffsets[from + 1]++;
+		dagTargets[i] = to;
+		inDegrees[to]++;
+	}
+	for (id_t component = 0; component < count; component++) {
+		dagOffsets[component + 1] += dagOffsets[component];
+	}
+
+	//topological order by Kahn algorithm
+	topologicalOrder.assign(count, 0);
+	vector<id_t> ready;
+	for (id_t component = 0; component < count; component++) {
+		if (inDegrees[component] == 0) {
+			ready.push_back(component);
+		}
+	}
+
+	id_t order = 0;
+	while (!ready.empty()) {
+		auto component = ready.back();
+		ready.pop_back();
+		topologicalOrder[component] = order++;
+
+		for (auto edge = dagOffsets[component]; edge < dagOffsets[component + 1]; edge++) {
+			if (--inDegrees[dagTargets[edge]] == 0) {
+				ready.push_back(dagTargets[edge]);
+			}
+		}
+	}
+
+	//interval labels of random depth first traversals
+	intervals.assign(static_cast<size_t>(labelCount) * count * 2, 0);
+	vector<id_t> roots(count);
+	vector<bool> visited;
+	vector<tuple<id_t, size_t>> stack;
+
+	for (unsigned int label = 0; label < labelCount; label++) {
+		mt19937 random(label + 1);
+
+		for (id_t component = 0; component < count; component++) {
+			roots[component] = component;
+			shuffle(dagTargets.begin() + dagOffsets[component], dagTargets.begin() + dagOffsets[component + 1], random);
+		}
+		shuffle(roots.begin(), roots.end(), random);
+
+		auto labelIntervals = intervals.data() + static_cast<size_t>(label) * count * 2;
+		visited.assign(count, false);
+		id_t postOrder = 0;
+
+		for (auto root : roots) {
+			if (visited[root]) {
+				continue;
+			}
+
+			visited[root] = true;
+			labelIntervals[root * 2] = noNode;
+			stack.push_back(tuple<id_t, size_t>(root, dagOffsets[root]));
+
+			while (!stack.empty()) {
+				auto& [component, edge] = stack.back();
+
+				if (edge < dagOffsets[component + 1]) {
+					auto child = dagTargets[edge++];
+
+					if (!visited[child]) {
+						visited[child] = true;
+						labelIntervals[child * 2] = noNode;
+						stack.push_back(tuple<id_t, size_t>(child, dagOffsets[child]));
+					}
+					else {
+						labelIntervals[component * 2] = min(labelIntervals[component * 2], labelIntervals[child * 2]);
+					}
+					continue;
+				}
+
+				//all children are finished
+				auto finished = component;
+				labelIntervals[finished * 2 + 1] = postOrder;
+				labelIntervals[finished * 2] = min(labelIntervals[finished * 2], postOrder);
+				postOrder++;
+				stack.pop_back();
+
+				if (!stack.empty()) {
+					auto parent = get<0>(stack.back());
+					labelIntervals[parent * 2] = min(labelIntervals[parent * 2], labelIntervals[finished * 2]);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+#pragma once
+#include "FlatGraph.h"
+#include "ThreadPool.h"
+
+/// <summary>
+/// strongly connected components of graph and reachability labels
+/// of the condensation graph, it proves that end node cannot be reached
+/// from start node without searching the graph
+/// </summary>
+/// <remarks>
+/// components are found by parallel forward-backward algorithm,
+/// every component gets topological order and interval labels
+/// of random depth first traversals of the condensation graph
+/// </remarks>
+class ReachabilityIndex
+{
+public:
+	/// <summary>
+	/// value used for nodes without component
+	/// </summary>
+	static constexpr id_t noNode = numeric_limits<id_t>::max();
+
+	/// <summary>
+	/// builds index of flat graph
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="threadPool">optional pool used to find components in parallel</param>
+	/// <param name="labelCount">number of interval labels of every component</param>
+	template <typename Cost_t>
+	ReachabilityIndex(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool = nullptr, unsigned int labelCount = 2);
+
+	/// <summary>
+	/// builds index of graph made of nodes
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="threadPool">optional pool used to find components in parallel</param>
+	/// <param name="labelCount">number of interval labels of every component</param>
+	template <typename Cost_t>
+	ReachabilityIndex(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, ThreadPool* threadPool = nullptr,
+		unsigned int labelCount = 2)
+		:ReachabilityIndex(FlatGraph<Cost_t>(graph), threadPool, labelCount) {}
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of strongly connected components</returns>
+	id_t getComponentCount() const { return componentCount; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>strongly connected component of the node</returns>
+	id_t getComponent(id_t id) const { return components[id]; }
+
+	/// <summary>
+	/// checks if there is no path betwean nodes, it takes O(labelCount) time
+	/// </summary>
+	/// <param name="startNodeId">starting node</param>
+	/// <param name="endNodeId">last node in searching path</param>
+	/// <returns>true if end node is not reachable for sure,
+	/// false if it is reachable or it cannot be proved</returns>
+	bool isUnreachable(id_t startNodeId, id_t endNodeId) const;
+
+private:
+	/// <summary>
+	/// part of graph which contains whole components
+	/// </summary>
+	struct Subproblem {
+		id_t color;
+		vector<id_t> nodes;
+	};
+
+	/// <summary>
+	/// builds index from offsets and targets
+	/// </summary>
+	void build(ThreadPool* threadPool, unsigned int labelCount);
+
+	/// <summary>
+	/// removes nodes without incoming or outgoing edges, they are components of one node
+	/// </summary>
+	void trim();
+
+	/// <summary>
+	/// splits subproblem to component of pivot, its forward set, backward set and the rest
+	/// </summary>
+	/// <param name="subproblem">nodes with the same color</param>
+	/// <returns>not empty subproblems which are left</returns>
+	vector<Subproblem> splitSubproblem(const Subproblem& subproblem);
+
+	/// <summary>
+	/// finds all components of subproblem in current thread
+	/// </summary>
+	void solveSubproblem(Subproblem subproblem);
+
+	/// <summary>
+	/// nodes of subproblem reachable from pivot
+	/// </summary>
+	/// <param name="color">color of subproblem</param>
+	/// <param name="pivot">first node</param>
+	/// <param name="forward">true for outgoing edges, false for incoming edges</param>
+	/// <param name="flag">flag set in marks for reached nodes</param>
+	void markReachable(id_t color, id_t pivot, bool forward, uint8_t flag);
+
+	/// <summary>
+	/// computes topological order and interval labels of condensation graph
+	/// </summary>
+	void labelCondensation(unsigned int labelCount);
+
+	/// <summary>
+	/// index of first outgoing edge for every node
+	/// </summary>
+	vector<size_t> offsets;
+
+	/// <summary>
+	/// neighbour of every outgoing edge
+	/// </summary>
+	vector<id_t> targets;
+
+	/// <summary>
+	/// index of first incoming edge for every node
+	/// </summary>
+	vector<size_t> reversedOffsets;
+
+	/// <summary>
+	/// neighbour of every incoming edge
+	/// </summary>
+	vector<id_t> reversedTargets;
+
+	/// <summary>
+	/// subproblem of every node during search of components
+	/// </summary>
+	vector<atomic<id_t>> colors;
+
+	/// <summary>
+	/// forward and backward flags of every node during search of components
+	/// </summary>
+	vector<uint8_t> marks;
+
+	/// <summary>
+	/// next free color
+	/// </summary>
+	atomic<id_t> nextColor = 1;
+
+	/// <summary>
+	/// strongly connected component of every node
+	/// </summary>
+	vector<id_t> components;
+
+	/// <summary>
+	/// number of strongly connected components
+	/// </summary>
+	atomic<id_t> componentCount = 0;
+
+	/// <summary>
+	/// topological order of every component in condensation graph
+	/// </summary>
+	vector<id_t> topologicalOrder;
+
+	/// <summary>
+	/// intervals of every component, for every labeling: lowest post order in subtree and post order
+	/// </summary>
+	vector<id_t> intervals;
+
+	/// <summary>
+	/// number of interval labels
+	/// </summary>
+	unsigned int labelCount = 0;
+};
+
+template<typename Cost_t>
+inline ReachabilityIndex::ReachabilityIndex(const FlatGraph<Cost_t>& graph, ThreadPool* threadPool, unsigned int labelCount)
+	:offsets(static_cast<size_t>(graph.getNodeCount()) + 1), targets(graph.getTargets())
+{
+	for (id_t id = 0; id <= graph.getNodeCount(); id++) {
+		offsets[id] = id < graph.getNodeCount() ? graph.firstEdge(id) : graph.getEdgeCount();
+	}
+
+	build(threadPool, labelCount);
+}
@@ -0,0 +1,262 @@
+#pragma once
+#include "BitOps.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SIMD_RELAXATION
+#include <immintrin.h>
+#endif
+
+#if defined(SIMD_RELAXATION) && (defined(__GNUC__) || defined(__clang__))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define SIMD_TARGET_AVX2
+#define SIMD_TARGET_AVX512
+#endif
+
+/// <summary>
+/// instruction set used by relaxation of edges
+/// </summary>
+enum class SimdLevel { scalar, avx2, avx512 };
+
+/// <summary>
+/// checks which vector instructions are supported by processor and system
+/// </summary>
+/// <returns>the best supported instruction set</returns>
+inline SimdLevel detectSimdLevel()
+{
+#if defined(SIMD_RELAXATION) && defined(_MSC_VER)
+	int info[4];
+
+	__cpuid(info, 0);
+	if (info[0] < 7) {
+		return SimdLevel::scalar;
+	}
+
+	//system must save vector registers (osxsave, avx)
+	__cpuid(info, 1);
+	if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+		return SimdLevel::scalar;
+	}
+
+	auto xcr0 = _xgetbv(0);
+	__cpuidex(info, 7, 0);
+
+	if ((info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6) {
+		return SimdLevel::avx512;
+	}
+	if ((info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6) {
+		return SimdLevel::avx2;
+	}
+	return SimdLevel::scalar;
+#elif defined(SIMD_RELAXATION)
+	__builtin_cpu_init();
+
+	if (__builtin_cpu_supports("avx512f")) {
+		return SimdLevel::avx512;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return SimdLevel::avx2;
+	}
+	return SimdLevel::scalar;
+#else
+	return SimdLevel::scalar;
+#endif
+}
+
+/// <summary>
+///
+/// </summary>
+/// <returns>instruction set detected once per process</returns>
+inline SimdLevel getSimdLevel()
+{
+	static const SimdLevel level = detectSimdLevel();
+	return level;
+}
+
+/// <summary>
+/// updates costs of neighbours selected by mask
+/// </summary>
+/// <param name="mask">bit for every improved lane</param>
+/// <param name="targets">neighbours of the batch</param>
+/// <param name="newCosts">costs of the batch computed in vector lanes</param>
+/// <param name="costs">cost of every node</param>
+/// <param name="onImproved">called with id and new cost of every improved neighbour</param>
+/// <remarks>cost is compared again, the same neighbour can be in the batch twice</remarks>
+template <typename Cost_t, typename Improved_t>
+inline void relaxLanes(uint64_t mask, const id_t* targets, const Cost_t* newCosts, Cost_t* costs, Improved_t& onImproved)
+{
+	for (; mask != 0; mask &= mask - 1) {
+		auto lane = countTrailingZeros(mask);
+		auto neigbourId = targets[lane];
+
+		if (costs[neigbourId] > newCosts[lane]) {
+			costs[neigbourId] = newCosts[lane];
+			onImproved(neigbourId, newCosts[lane]);
+		}
+	}
+}
+
+/// <summary>
+/// relaxes edges one by one
+/// </summary>
+/// <param name="targets">neighbours of node</param>
+/// <param name="weights">costs of edges to neighbours</param>
+/// <param name="count">number of edges</param>
+/// <param name="cost">cost of node</param>
+/// <param name="costs">cost of every node</param>
+/// <param name="onImproved">called with id and new cost of every improved neighbour</param>
+template <typename Cost_t, typename Improved_t>
+inline void relaxEdgesScalar(const id_t* targets, const Cost_t* weights, size_t count, Cost_t cost,
+	Cost_t* costs, Improved_t& onImproved)
+{
+	for (size_t edge = 0; edge < count; edge++) {
+		auto newNeigbourCost = cost + weights[edge];
+		auto neigbourId = targets[edge];
+
+		if (costs[neigbourId] > newNeigbourCost) {
+			costs[neigbourId] = newNeigbourCost;
+			onImproved(neigbourId, newNeigbourCost);
+		}
+	}
+}
+
+#ifdef SIMD_RELAXATION
+
+/// <summary>
+/// relaxes batches of 8 edges with AVX2
+/// </summary>
+/// <returns>number of relaxed edges</returns>
+template <typename Improved_t>
+SIMD_TARGET_AVX2 size_t relaxEdgesAvx2(const id_t* targets, const int32_t* weights, size_t count, int32_t cost,
+	int32_t* costs, Improved_t& onImproved)
+{
+	alignas(32) int32_t newCosts[8];
+	const auto costLanes = _mm256_set1_epi32(cost);
+
+	size_t edge = 0;
+	for (; edge + 8 <= count; edge += 8) {
+		auto ids = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(targets + edge));
+		auto current = _mm256_i32gather_epi32(costs, ids, 4);
+		auto candidate = _mm256_add_epi32(costLanes, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + edge)));
+		auto mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(current, candidate)));
+
+		if (mask != 0) {
+			_mm256_store_si256(reinterpret_cast<__m256i*>(newCosts), candidate);
+			relaxLanes(static_cast<uint64_t>(mask), targets + edge, newCosts, costs, onImproved);
+		}
+	}
+	return edge;
+}
+
+/// <summary>
+/// relaxes batches of 8 edges with AVX2
+/// </summary>
+/// <returns>number of relaxed edges</returns>
+template <typename Improved_t>
+SIMD_TARGET_AVX2 size_t relaxEdgesAvx2(const id_t* targets, const float* weights, size_t count, float cost,
+	float* costs, Improved_t& onImproved)
+{
+	alignas(32) float newCosts[8];
+	const auto costLanes = _mm256_set1_ps(cost);
+
+	size_t edge = 0;
+	for (; edge + 8 <= count; edge += 8) {
+		auto ids = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(targets + edge));
+		auto current = _mm256_i32gather_ps(costs, ids, 4);
+		auto candidate = _mm256_add_ps(costLanes, _mm256_loadu_ps(weights + edge));
+		auto mask = _mm256_movemask_ps(_mm256_cmp_ps(current, candidate, _CMP_GT_OQ));
+
+		if (mask != 0) {
+			_mm256_store_ps(newCosts, candidate);
+			relaxLanes(static_cast<uint64_t>(mask), targets + edge, newCosts, costs, onImproved);
+		}
+	}
+	return edge;
+}
+
+/// <summary>
+/// relaxes batches of 16 edges with AVX-512
+/// </summary>
+/// <returns>number of relaxed edges</returns>
+template <typename Improved_t>
+SIMD_TARGET_AVX512 size_t relaxEdgesAvx512(const id_t* targets, const int32_t* weights, size_t count, int32_t cost,
+	int32_t* costs, Improved_t& onImproved)
+{
+	alignas(64) int32_t newCosts[16];
+	const auto costLanes = _mm512_set1_epi32(cost);
+
+	size_t edge = 0;
+	for (; edge + 16 <= count; edge += 16) {
+		auto ids = _mm512_loadu_si512(targets + edge);
+		auto current = _mm512_i32gather_epi32(ids, costs, 4);
+		auto candidate = _mm512_add_epi32(costLanes, _mm512_loadu_si512(weights + edge));
+		auto mask = _mm512_cmpgt_epi32_mask(current, candidate);
+
+		if (mask != 0) {
+			_mm512_store_si512(newCosts, candidate);
+			relaxLanes(static_cast<uint64_t>(mask), targets + edge, newCosts, costs, onImproved);
+		}
+	}
+	return edge;
+}
+
+/// <summary>
+/// relaxes batches of 16 edges with AVX-512
+/// </summary>
+/// <returns>number of relaxed edges</returns>
+template <typename Improved_t>
+SIMD_TARGET_AVX512 size_t relaxEdgesAvx512(const id_t* targets, const float* weights, size_t count, float cost,
+	float* costs, Improved_t& onImproved)
+{
+	alignas(64) float newCosts[16];
+	const auto costLanes = _mm512_set1_ps(cost);
+
+	size_t edge = 0;
+	for (; edge + 16 <= count; edge += 16) {
+		auto ids = _mm512_loadu_si512(targets + edge);
+		auto current = _mm512_i32gather_ps(ids, costs, 4);
+		auto candidate = _mm512_add_ps(costLanes, _mm512_loadu_ps(weights + edge));
+		auto mask = _mm512_cmp_ps_mask(current, candidate, _CMP_GT_OQ);
+
+		if (mask != 0) {
+			_mm512_store_ps(newCosts, candidate);
+			relaxLanes(static_cast<uint64_t>(mask), targets + edge, newCosts, costs, onImproved);
+		}
+	}
+	return edge;
+}
+
+#endif
+
+/// <summary>
+/// relaxes all edges of node: computes cost + weight for every neighbour,
+/// compares it with current cost and updates improved neighbours
+/// </summary>
+/// <param name="targets">neighbours of node</param>
+/// <param name="weights">costs of edges to neighbours</param>
+/// <param name="count">number of edges</param>
+/// <param name="cost">cost of node</param>
+/// <param name="costs">cost of every node, ids must be smaller than 2^31</param>
+/// <param name="onImproved">called with id and new cost of every improved neighbour</param>
+/// <param name="level">instruction set, int and float costs use vector instructions</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+template <typename Cost_t, typename Improved_t>
+inline void relaxEdges(const id_t* targets, const Cost_t* weights, size_t count, Cost_t cost,
+	Cost_t* costs, Improved_t&& onImproved, SimdLevel level = getSimdLevel())
+{
+	size_t relaxed = 0;
+
+#ifdef SIMD_RELAXATION
+	if constexpr (is_same<Cost_t, int32_t>::value || is_same<Cost_t, float>::value) {
+		if (level == SimdLevel::avx512) {
+			relaxed = relaxEdgesAvx512(targets, weights, count, cost, costs, onImproved);
+		}
+		else if (level == SimdLevel::avx2) {
+			relaxed = relaxEdgesAvx2(targets, weights, count, cost, costs, onImproved);
+		}
+	}
+#endif
+
+	relaxEdgesScalar(targets + relaxed, weights + relaxed, count - relaxed, cost, costs, onImproved);
+}
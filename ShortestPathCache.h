@@ -0,0 +1,221 @@
+#pragma once
+#include "ShortestPathTree.h"
+
+/// <summary>
+/// cache of shortest path trees, key is the start node,
+/// least recently used trees are removed when memory budget is exceeded
+/// </summary>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// it is thread safe, start nodes are split betwean shards with separate locks,
+/// trees are invalidated when the version counter of graph changes
+/// </remarks>
+template <typename Cost_t>
+class ShortestPathCache
+{
+	using TreePtr = shared_ptr<const ShortestPathTree<Cost_t>>;
+
+public:
+	/// <summary>
+	/// creates empty cache, it sets version counter in nodes of graph
+	/// </summary>
+	/// <param name="graph">definition of graph, it must live longer than cache</param>
+	/// <param name="memoryBudget">max number of bytes used by cached trees</param>
+	/// <param name="shardCount">number of independently locked parts of cache</param>
+	ShortestPathCache(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, size_t memoryBudget,
+		unsigned int shardCount = 16);
+
+	/// <summary>
+	/// finds shortest path, the tree of start node is taken from cache
+	/// or computed by dijstra algorithm
+	/// </summary>
+	/// <param name="startNodeId">starting node</param>
+	/// <param name="endNodeId">last node in searching path</param>
+	/// <returns>tuple: shortest path(deque) and cost of the path</returns>
+	tuple<deque<id_t>, Cost_t> shortestPath(id_t startNodeId, id_t endNodeId);
+
+	/// <summary>
+	/// gets tree of shortest paths from cache or computes it
+	/// </summary>
+	/// <param name="startNodeId">root of the tree</param>
+	/// <returns>tree of shortest paths</returns>
+	TreePtr getTree(id_t startNodeId);
+
+	/// <summary>
+	/// removes all trees
+	/// </summary>
+	void clear();
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of bytes used by cached trees</returns>
+	size_t getMemoryUsage();
+
+private:
+	/// <summary>
+	/// cached tree with version of graph which was used to compute it
+	/// </summary>
+	struct Entry {
+		TreePtr tree;
+		unsigned long long version;
+		list<id_t>::iterator lruPosition;
+	};
+
+	/// <summary>
+	/// part of cache with own lock
+	/// </summary>
+	struct Shard {
+		mutex mtx;
+
+		/// <summary>
+		/// start nodes, most recently used first
+		/// </summary>
+		list<id_t> lru;
+
+		unordered_map<id_t, Entry> entries;
+
+		size_t memoryUsage = 0;
+	};
+
+	/// <summary>
+	/// removes entry, shard must be locked
+	/// </summary>
+	void erase(Shard& shard, typename unordered_map<id_t, Entry>::iterator it);
+
+	/// <summary>
+	/// definition of graph
+	/// </summary>
+	const vector<shared_ptr<NodeInPath<Cost_t>>>& graph;
+
+	/// <summary>
+	/// counter of graph changes
+	/// </summary>
+	shared_ptr<atomic_ullong> version;
+
+	/// <summary>
+	/// max number of bytes used by one shard
+	/// </summary>
+	size_t shardBudget;
+
+	/// <summary>
+	/// parts of cache
+	/// </summary>
+	vector<unique_ptr<Shard>> shards;
+};
+
+template<typename Cost_t>
+inline ShortestPathCache<Cost_t>::ShortestPathCache(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	size_t memoryBudget, unsigned int shardCount)
+	:graph(graph), shardBudget(memoryBudget / max(shardCount, 1u))
+{
+	for (const auto& node : graph) {
+		if (node->getVersionCounter() != nullptr) {
+			version = node->getVersionCounter();
+			break;
+		}
+	}
+
+	if (version == nullptr) {
+		version = make_shared<atomic_ullong>(0);
+	}
+
+	for (const auto& node : graph) {
+		assert(node->getVersionCounter() == nullptr || node->getVersionCounter() == version);
+		node->setVersionCounter(version);
+	}
+
+	for (unsigned int i = 0; i < max(shardCount, 1u); i++) {
+		shards.push_back(make_unique<Shard>());
+	}
+}
+
+template<typename Cost_t>
+inline tuple<deque<id_t>, Cost_t> ShortestPathCache<Cost_t>::shortestPath(id_t startNodeId, id_t endNodeId)
+{
+	auto tree = getTree(startNodeId);
+
+	auto path = tree->getPath(endNodeId);
+	auto minCost = tree->getCost(endNodeId);
+
+	return tuple<decltype(path), decltype(minCost)>(path, minCost);
+}
+
+template<typename Cost_t>
+typename ShortestPathCache<Cost_t>::TreePtr ShortestPathCache<Cost_t>::getTree(id_t startNodeId)
+{
+	auto& shard = *shards[startNodeId % shards.size()];
+	auto currentVersion = version->load();
+	{
+		lock_guard lock(shard.mtx);
+
+		auto it = shard.entries.find(startNodeId);
+		if (it != shard.entries.end()) {
+			if (it->second.version == currentVersion) {
+				shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPosition);
+				return it->second.tree;
+			}
+			erase(shard, it);
+		}
+	}
+
+	//tree is computed without lock, so other start nodes in the shard are not blocked
+	TreePtr tree = make_shared<const ShortestPathTree<Cost_t>>(dijstraShortestPathTree(graph, startNodeId));
+	auto treeSize = tree->getMemorySize();
+
+	if (treeSize > shardBudget) {
+		return tree;
+	}
+
+	lock_guard lock(shard.mtx);
+
+	auto it = shard.entries.find(startNodeId);
+	if (it != shard.entries.end()) {
+		if (it->second.version >= currentVersion) {
+			return it->second.tree;
+		}
+		erase(shard, it);
+	}
+
+	while (shard.memoryUsage + treeSize > shardBudget) {
+		erase(shard, shard.entries.find(shard.lru.back()));
+	}
+
+	shard.lru.push_front(startNodeId);
+	shard.entries[startNodeId] = Entry{ tree, currentVersion, shard.lru.begin() };
+	shard.memoryUsage += treeSize;
+
+	return tree;
+}
+
+template<typename Cost_t>
+inline void ShortestPathCache<Cost_t>::clear()
+{
+	for (auto& shard : shards) {
+		lock_guard lock(shard->mtx);
+		shard->entries.clear();
+		shard->lru.clear();
+		shard->memoryUsage = 0;
+	}
+}
+
+template<typename Cost_t>
+inline size_t ShortestPathCache<Cost_t>::getMemoryUsage()
+{
+	size_t usage = 0;
+
+	for (auto& shard : shards) {
+		lock_guard lock(shard->mtx);
+		usage += shard->memoryUsage;
+	}
+
+	return usage;
+}
+
+template<typename Cost_t>
+inline void ShortestPathCache<Cost_t>::erase(Shard& shard, typename unordered_map<id_t, Entry>::iterator it)
+{
+	shard.memoryUsage -= it->second.tree->getMemorySize();
+	shard.lru.erase(it->second.lruPosition);
+	shard.entries.erase(it);
+}
@@ -0,0 +1,141 @@
+#pragma once
+#include "NodeInPath.h"
+
+/// <summary>
+/// shortest paths from one start node to all nodes of graph
+/// </summary>
+/// <typeparm name="Cost_t">type of cost betwean two nodes</typeparm>
+template <typename Cost_t>
+class ShortestPathTree
+{
+public:
+	/// <summary>
+	/// value of prevNodes for nodes without previous node
+	/// </summary>
+	static constexpr id_t noNode = numeric_limits<id_t>::max();
+
+	/// <summary>
+	/// creates tree where no node is reached
+	/// </summary>
+	/// <param name="size">number of nodes in graph</param>
+	/// <param name="startNodeId">root of the tree</param>
+	ShortestPathTree(id_t size, id_t startNodeId);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>root of the tree</returns>
+	id_t getStartNodeId() const { return startNodeId; }
+
+	/// <summary>
+	/// returns cost of path from start node to selected node
+	/// </summary>
+	/// <param name="id">selected node</param>
+	/// <returns>cost of node, max value if node is not reachable</returns>
+	Cost_t getCost(id_t id) const { return costs[id]; }
+
+	/// <summary>
+	/// gets path from start node to end node
+	/// </summary>
+	/// <param name="endNode">id of end node</param>
+	/// <returns>list of ids in path</returns>
+	deque<id_t> getPath(id_t endNode) const;
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of bytes used by the tree</returns>
+	size_t getMemorySize() const;
+
+	/// <summary>
+	/// cost of every node
+	/// </summary>
+	vector<Cost_t> costs;
+
+	/// <summary>
+	/// previous node in path for every node
+	/// </summary>
+	vector<id_t> prevNodes;
+
+private:
+	/// <summary>
+	/// root of the tree
+	/// </summary>
+	id_t startNodeId;
+};
+
+template<typename Cost_t>
+inline ShortestPathTree<Cost_t>::ShortestPathTree(id_t size, id_t startNodeId)
+	:costs(size, numeric_limits<Cost_t>::max()), prevNodes(size, noNode), startNodeId(startNodeId)
+{
+}
+
+template<typename Cost_t>
+inline deque<id_t> ShortestPathTree<Cost_t>::getPath(id_t endNode) const
+{
+	deque<id_t> path;
+
+	path.push_front(endNode);
+
+	for (auto prevId = prevNodes[endNode]; prevId != noNode; prevId = prevNodes[prevId]) {
+		path.push_front(prevId);
+	}
+
+	return path;
+}
+
+template<typename Cost_t>
+inline size_t ShortestPathTree<Cost_t>::getMemorySize() const
+{
+	return sizeof(*this) + costs.capacity() * sizeof(Cost_t) + prevNodes.capacity() * sizeof(id_t);
+}
+
+/// <summary>
+/// finds shortest paths from start node to all nodes using dijstra algorithm
+/// </summary>
+/// <param name="graph">definition of graph</param>
+/// <param name="startNodeId">starting node</param>
+/// <typeparm name="Cost_t">must be numeric type, type of cost betwean two nodes</typeparm>
+/// <returns>tree of shortest paths</returns>
+template <typename Cost_t>
+ShortestPathTree<Cost_t> dijstraShortestPathTree(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph,
+	id_t startNodeId)
+{
+	using CostAndId = tuple<Cost_t, id_t>;
+
+	ShortestPathTree<Cost_t> tree(static_cast<id_t>(graph.size()), startNodeId);
+	priority_queue<CostAndId, vector<CostAndId>, greater<CostAndId>> queue;
+
+	tree.costs[startNodeId] = 0;
+	queue.push(CostAndId(tree.costs[startNodeId], startNodeId));
+
+	while (!queue.empty()) {
+
+		auto [cost, processNodeId] = queue.top();
+		queue.pop();
+
+		//node was already processed with smaller cost
+		if (tree.costs[processNodeId] < cost) {
+			continue;
+		}
+
+		for (const auto& [weakNeighbour, neigbourCost] : graph[processNodeId]->getNeighbours()) {
+
+			assert(neigbourCost >= 0);
+
+			auto neighbour = weakNeighbour.lock();
+			if (neighbour != nullptr) {
+				auto newNeigbourCost = cost + neigbourCost;
+
+				auto neigbourId = neighbour->getId();
+				if (tree.costs[neigbourId] > newNeigbourCost) {
+					tree.costs[neigbourId] = newNeigbourCost;
+					tree.prevNodes[neigbourId] = processNodeId;
+					queue.push(CostAndId(newNeigbourCost, neigbourId));
+				}
+			}
+		}
+	}
+
+	return tree;
+}
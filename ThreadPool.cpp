@@ -1,56 +1,211 @@
 #include "pch.h"
 #include "ThreadPool.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
-ThreadPool::ThreadPool()
+/// <summary>
+/// Pool of the current thread
+/// </summary>
+static thread_local ThreadPool* currentPool = nullptr;
+
+/// <summary>
+/// Queue of the current thread
+/// </summary>
+static thread_local size_t currentQueue = 0;
+
+/// <summary>
+/// Scratch memory of the current thread
+/// </summary>
+static thread_local pmr::memory_resource* currentScratch = nullptr;
+
+/// <summary>
+/// Pins the current thread to processor
+/// </summary>
+/// <param name="cpu">Id of processor</param>
+/// <returns>False if the thread could not be pinned</returns>
+static bool pinCurrentThread(unsigned int cpu)
 {
-	const auto thread_count = thread::hardware_concurrency();
+#ifdef _WIN32
+	//only processors of the current processor group can be selected
+	if (cpu >= sizeof(DWORD_PTR) * 8) {
+		return false;
+	}
+	return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#elif defined(__linux__)
+	if (cpu >= CPU_SETSIZE) {
+		return false;
+	}
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	CPU_SET(cpu, &cpuSet);
+	return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+	return false;
+#endif
+}
 
-	for (unsigned int i = 0; i < thread_count; i++) {
-		threads.push_back(thread([this]() 
-		{
-			while (!stopThreads) {
-				activeThreadsMtx.lock();
-				auto [ok, task] = tasks.tryPop();
-
-				if (ok) {
-					activThreads++;
-					activeThreadsMtx.unlock();
-					task();
-					activeThreadsMtx.lock();
-					activThreads--;
-					activeThreadsMtx.unlock();
-				}
-				else {
-					activeThreadsMtx.unlock();
-					this_thread::yield();
-				}
-			}
-		}));
+ThreadPool::ThreadPool(const ThreadPoolConfig& config) :config(config)
+{
+	maxThreads = max(config.threadCount, 1u);
+
+	//only nodes with at least one thread get a queue, so every queue has workers
+	for (unsigned int i = 0; i < maxThreads && !config.numaNodes.empty(); i++) {
+		auto node = config.numaNodes[i % config.numaNodes.size()];
+		if (find(queueNodes.begin(), queueNodes.end(), node) == queueNodes.end()) {
+			queueNodes.push_back(node);
+		}
+	}
+
+	for (size_t i = 0; i < max<size_t>(queueNodes.size(), 1); i++) {
+		tasks.push_back(make_unique<BlockingQueue<packaged_task<void()>>>());
 	}
+
+	for (unsigned int i = 0; i < maxThreads; i++) {
+		threads.push_back(thread([this, i]() { run(i); }));
+	}
+
+	//results of pinning are known when the pool is created
+	unique_lock lock(idleMtx);
+	startedCondition.wait(lock, [this]() { return startedThreads == maxThreads; });
 }
 
 ThreadPool::~ThreadPool()
 {
 	stopThreads = true;
 
+	{
+		lock_guard lock(idleMtx);
+	}
+	idleCondition.notify_all();
+
 	for (auto& thread : threads) {
 		if (thread.joinable()) {
 			thread.join();
 		}
-		
+
 	}
 }
 
 future<void> ThreadPool::submit(function<void()>&& task)
 {
+	//tasks submited by threads of the pool stay on their NUMA node
+	auto queueIndex = currentPool == this ? currentQueue : nextQueue++ % tasks.size();
+
+	auto pack = packaged_task<void()>(move(task));
+	auto fut = pack.get_future();
+	push(queueIndex, move(pack));
+	return fut;
+}
+
+future<void> ThreadPool::submit(function<void()>&& task, unsigned int numaNode)
+{
+	auto queueIndex = getQueueIndex(numaNode);
+	if (queueIndex == tasks.size()) {
+		return submit(move(task));
+	}
+
 	auto pack = packaged_task<void()>(move(task));
 	auto fut = pack.get_future();
-	tasks.push(packaged_task(move(pack)));
+	push(queueIndex, move(pack));
 	return fut;
 }
 
 bool ThreadPool::isFull()
 {
-	lock_guard lock(activeThreadsMtx);
 	return activThreads == maxThreads;
 }
+
+void ThreadPool::push(size_t queueIndex, packaged_task<void()>&& task)
+{
+	//counted before push, so a thread which pops the task never sees zero
+	pendingTasks++;
+	tasks[queueIndex]->push(move(task));
+
+	//idle thread checks pendingTasks under the mutex, so it cannot miss the notification
+	if (idleThreads > 0) {
+		{
+			lock_guard lock(idleMtx);
+		}
+		idleCondition.notify_one();
+	}
+}
+
+size_t ThreadPool::getQueueIndex(unsigned int numaNode) const
+{
+	auto node = find(queueNodes.begin(), queueNodes.end(), numaNode);
+	return node == queueNodes.end() ? tasks.size() : node - queueNodes.begin();
+}
+
+pmr::memory_resource* ThreadPool::getScratch()
+{
+	return currentScratch;
+}
+
+void ThreadPool::run(unsigned int threadIndex)
+{
+	size_t queueIndex = config.numaNodes.empty() ? 0 : getQueueIndex(config.numaNodes[threadIndex % config.numaNodes.size()]);
+
+	if (!config.cpus.empty() && !pinCurrentThread(config.cpus[threadIndex % config.cpus.size()])) {
+		unpinnedThreads++;
+	}
+
+	{
+		lock_guard lock(idleMtx);
+		startedThreads++;
+	}
+	startedCondition.notify_one();
+
+	//memory is first touched by this thread, after pinning, so it is placed on its NUMA node
+	unique_ptr<char[]> scratchBuffer;
+	unique_ptr<pmr::monotonic_buffer_resource> scratchBlocks;
+	unique_ptr<pmr::unsynchronized_pool_resource> scratch;
+
+	if (config.scratchSize > 0) {
+		scratchBuffer = make_unique<char[]>(config.scratchSize);
+		scratchBlocks = make_unique<pmr::monotonic_buffer_resource>(scratchBuffer.get(), config.scratchSize);
+		scratch = make_unique<pmr::unsynchronized_pool_resource>(scratchBlocks.get());
+	}
+
+	currentPool = this;
+	currentQueue = queueIndex;
+	currentScratch = scratch.get();
+
+	while (!stopThreads) {
+		auto [ok, task] = tryPop(queueIndex);
+
+		if (ok) {
+			activThreads++;
+			task();
+			activThreads--;
+		}
+		else {
+			unique_lock lock(idleMtx);
+			idleThreads++;
+			idleCondition.wait(lock, [this]() { return pendingTasks > 0 || stopThreads; });
+			idleThreads--;
+		}
+	}
+
+	currentScratch = nullptr;
+	currentPool = nullptr;
+}
+
+tuple<bool, packaged_task<void()>> ThreadPool::tryPop(size_t queueIndex)
+{
+	//own queue first, then tasks are stolen from other nodes
+	for (size_t i = 0; i < tasks.size(); i++) {
+		auto result = tasks[(queueIndex + i) % tasks.size()]->tryPop();
+
+		if (get<0>(result)) {
+			pendingTasks--;
+			return result;
+		}
+	}
+
+	return tuple(false, packaged_task<void()>());
+}
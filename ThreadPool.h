@@ -1,16 +1,23 @@
 #pragma once
 #include "BlockingQueue.h"
+#include "ThreadPoolConfig.h"
 
 /// <summary>
-/// Thread pool where max threads = nubmer of processors
+/// Thread pool where by default max threads = nubmer of processors
 /// </summary>
+/// <remarks>
+/// Every NUMA node used by threads has own queue of tasks with own lock,
+/// threads take tasks from the queue of their node first and then from queues of other nodes,
+/// threads without tasks sleep until a task is submited
+/// </remarks>
 class ThreadPool
 {
 public:
 	/// <summary>
 	/// Creates and starts threads.
 	/// </summary>
-	ThreadPool();
+	/// <param name="config">Number of threads, pinning and queues of the pool</param>
+	ThreadPool(const ThreadPoolConfig& config = ThreadPoolConfig());
 
 	/// <summary>
 	/// Stops all threads
@@ -24,12 +31,90 @@ public:
 	/// <returns>The futre object of submited task</returns>
 	future<void> submit(function<void()>&& task);
 
+	/// <summary>
+	/// Submits a task to the queue of NUMA node
+	/// </summary>
+	/// <param name="task">A task to submit</param>
+	/// <param name="numaNode">NUMA node from config of the pool, if no thread uses it the task is submited as usual</param>
+	/// <returns>The futre object of submited task</returns>
+	future<void> submit(function<void()>&& task, unsigned int numaNode);
+
+	/// <summary>
+	/// Submits a task which returns a value
+	/// </summary>
+	/// <param name="task">A task to submit</param>
+	/// <typeparam name="Result_t">type of value returned by the task</typeparam>
+	/// <returns>The futre object with the value of submited task</returns>
+	template <typename Result_t>
+	future<Result_t> submit(function<Result_t()>&& task);
+
 	/// <summary>
 	/// Is there any idle threads
 	/// </summary>
 	/// <returns>Thread pool is full, no idle threads</returns>
 	bool isFull();
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>Number of threads in the pool</returns>
+	size_t getThreadCount() { return threads.size(); }
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>Number of task queues, one per NUMA node used by threads</returns>
+	size_t getQueueCount() const { return tasks.size(); }
+
+	/// <summary>
+	/// 
+	/// </summary>
+	/// <returns>Number of threads which could not be pinned to processor from config</returns>
+	unsigned int getUnpinnedThreadCount() const { return unpinnedThreads; }
+
+	/// <summary>
+	/// Scratch memory of the current thread, allocated by the thread 
+	/// so it is local to its NUMA node
+	/// </summary>
+	/// <remarks>
+	/// when more than scratchSize bytes are used, next blocks come from the default resource
+	/// and they can be placed on other NUMA node
+	/// </remarks>
+	/// <returns>Memory of the current thread, nullptr if it is not a thread of pool with scratch memory</returns>
+	static pmr::memory_resource* getScratch();
 private:
+	/// <summary>
+	/// Body of every thread
+	/// </summary>
+	/// <param name="threadIndex">Index of thread in config</param>
+	void run(unsigned int threadIndex);
+
+	/// <summary>
+	/// Gets task from the queue of thread or from other queues
+	/// </summary>
+	/// <param name="queueIndex">Queue of the thread</param>
+	/// <returns>False if all queues are empty, true and the task otherwise</returns>
+	tuple<bool, packaged_task<void()>> tryPop(size_t queueIndex);
+
+	/// <summary>
+	/// Finds queue of NUMA node
+	/// </summary>
+	/// <param name="numaNode">NUMA node from config of the pool</param>
+	/// <returns>Index of queue, number of queues if no thread uses the node</returns>
+	size_t getQueueIndex(unsigned int numaNode) const;
+
+	/// <summary>
+	/// Adds task to queue and wakes an idle thread
+	/// </summary>
+	/// <param name="queueIndex">Index of queue</param>
+	/// <param name="task">A task to submit</param>
+	void push(size_t queueIndex, packaged_task<void()>&& task);
+
+	/// <summary>
+	/// Settings of the pool
+	/// </summary>
+	ThreadPoolConfig config;
+
 	/// <summary>
 	/// Should all threads be stopped?
 	/// </summary>
@@ -41,9 +126,19 @@ private:
 	vector<thread> threads;
 
 	/// <summary>
-	/// List of submited tasks, waiting to be run
+	/// Lists of submited tasks, waiting to be run, one per NUMA node
+	/// </summary>
+	vector<unique_ptr<BlockingQueue<packaged_task<void()>>>> tasks;
+
+	/// <summary>
+	/// NUMA node of every queue, empty if all threads use one queue
+	/// </summary>
+	vector<unsigned int> queueNodes;
+
+	/// <summary>
+	/// Queue of tasks submited from outside the pool
 	/// </summary>
-	BlockingQueue<packaged_task<void()>> tasks;
+	atomic_uint nextQueue = 0;
 
 	/// <summary>
 	/// 
@@ -53,11 +148,49 @@ private:
 	/// <summary>
 	/// How many thread are performing tasks
 	/// </summary>
-	short activThreads=0;
+	atomic_uint activThreads = 0;
+
+	/// <summary>
+	/// How many tasks are waiting in all queues
+	/// </summary>
+	atomic_size_t pendingTasks = 0;
 
 	/// <summary>
-	/// Guard for activThreads field
+	/// How many threads wait for tasks
 	/// </summary>
-	mutex activeThreadsMtx;
+	atomic_uint idleThreads = 0;
+
+	/// <summary>
+	/// How many threads are started and pinned, guarded by idleMtx
+	/// </summary>
+	unsigned int startedThreads = 0;
+
+	/// <summary>
+	/// How many threads could not be pinned
+	/// </summary>
+	atomic_uint unpinnedThreads = 0;
+
+	/// <summary>
+	/// Guard for sleeping of idle threads, queues have own locks
+	/// </summary>
+	mutex idleMtx;
+
+	/// <summary>
+	/// Idle threads wait for new tasks
+	/// </summary>
+	condition_variable idleCondition;
+
+	/// <summary>
+	/// Constructor waits until all threads are started
+	/// </summary>
+	condition_variable startedCondition;
 };
 
+template<typename Result_t>
+inline future<Result_t> ThreadPool::submit(function<Result_t()>&& task)
+{
+	auto pack = make_shared<packaged_task<Result_t()>>(move(task));
+	auto fut = pack->get_future();
+	submit([pack]() { (*pack)(); });
+	return fut;
+}
@@ -0,0 +1,173 @@
+#include "pch.h"
+#include "ThreadPoolConfig.h"
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fstream>
+#include <string>
+#include <cctype>
+#ifdef __linux__
+#include <sched.h>
+#endif
+#endif
+
+/// <summary>
+/// Removes processors where the process is not allowed to run
+/// </summary>
+/// <param name="cpus">List of processors</param>
+static void keepAllowedCpus(vector<unsigned int>& cpus)
+{
+	auto allowed = ThreadPoolConfig::allowedCpus();
+
+	if (!allowed.empty()) {
+		cpus.erase(remove_if(cpus.begin(), cpus.end(), [&allowed](unsigned int cpu) {
+			return !binary_search(allowed.begin(), allowed.end(), cpu);
+			}), cpus.end());
+	}
+}
+
+ThreadPoolConfig ThreadPoolConfig::forNumaNode(unsigned int numaNode)
+{
+	ThreadPoolConfig config;
+	auto nodeCpus = numaNodeCpus(numaNode);
+	keepAllowedCpus(nodeCpus);
+
+	if (!nodeCpus.empty()) {
+		config.threadCount = static_cast<unsigned int>(nodeCpus.size());
+		config.cpus = move(nodeCpus);
+		config.numaNodes = { numaNode };
+	}
+
+	return config;
+}
+
+ThreadPoolConfig ThreadPoolConfig::numaAware()
+{
+	ThreadPoolConfig config;
+
+	for (unsigned int node = 0; node < numaNodeCount(); node++) {
+		auto nodeCpus = numaNodeCpus(node);
+		keepAllowedCpus(nodeCpus);
+
+		for (auto cpu : nodeCpus) {
+			config.cpus.push_back(cpu);
+			config.numaNodes.push_back(node);
+		}
+	}
+
+	if (!config.cpus.empty()) {
+		config.threadCount = static_cast<unsigned int>(config.cpus.size());
+	}
+
+	return config;
+}
+
+#ifdef _WIN32
+
+unsigned int ThreadPoolConfig::numaNodeCount()
+{
+	ULONG highestNode = 0;
+
+	if (!GetNumaHighestNodeNumber(&highestNode)) {
+		return 1;
+	}
+
+	return highestNode + 1;
+}
+
+vector<unsigned int> ThreadPoolConfig::numaNodeCpus(unsigned int numaNode)
+{
+	vector<unsigned int> cpus;
+	ULONGLONG mask = 0;
+
+	//only processors of the current processor group are reported
+	if (numaNode <= numeric_limits<UCHAR>::max() && GetNumaNodeProcessorMask(static_cast<UCHAR>(numaNode), &mask)) {
+		for (unsigned int cpu = 0; cpu < 64; cpu++) {
+			if (mask & (ULONGLONG(1) << cpu)) {
+				cpus.push_back(cpu);
+			}
+		}
+	}
+
+	return cpus;
+}
+
+vector<unsigned int> ThreadPoolConfig::allowedCpus()
+{
+	vector<unsigned int> cpus;
+	DWORD_PTR processMask = 0;
+	DWORD_PTR systemMask = 0;
+
+	//only processors of the current processor group are reported
+	if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+		for (unsigned int cpu = 0; cpu < sizeof(DWORD_PTR) * 8; cpu++) {
+			if (processMask & (DWORD_PTR(1) << cpu)) {
+				cpus.push_back(cpu);
+			}
+		}
+	}
+
+	return cpus;
+}
+
+#else
+
+unsigned int ThreadPoolConfig::numaNodeCount()
+{
+	unsigned int count = 0;
+
+	while (ifstream("/sys/devices/system/node/node" + to_string(count) + "/cpulist")) {
+		count++;
+	}
+
+	return max(count, 1u);
+}
+
+vector<unsigned int> ThreadPoolConfig::numaNodeCpus(unsigned int numaNode)
+{
+	vector<unsigned int> cpus;
+	ifstream file("/sys/devices/system/node/node" + to_string(numaNode) + "/cpulist");
+
+	if (!file) {
+		return cpus;
+	}
+
+	//format of the list: 0-3,8,10-11
+	string range;
+	while (getline(file, range, ',')) {
+		if (range.empty() || !isdigit(static_cast<unsigned char>(range[0]))) {
+			continue;
+		}
+
+		auto dash = range.find('-');
+		auto first = static_cast<unsigned int>(stoul(range));
+		auto last = dash == string::npos ? first : static_cast<unsigned int>(stoul(range.substr(dash + 1)));
+
+		for (auto cpu = first; cpu <= last; cpu++) {
+			cpus.push_back(cpu);
+		}
+	}
+
+	return cpus;
+}
+
+vector<unsigned int> ThreadPoolConfig::allowedCpus()
+{
+	vector<unsigned int> cpus;
+#ifdef __linux__
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+
+	if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+		for (unsigned int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if (CPU_ISSET(cpu, &cpuSet)) {
+				cpus.push_back(cpu);
+			}
+		}
+	}
+#endif
+	return cpus;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+/// <summary>
+/// settings of thread pool: number of threads, pinning to processors,
+/// task queues of NUMA nodes and scratch memory of threads
+/// </summary>
+/// <remarks>
+/// default config creates one unpinned thread per processor with one common queue
+/// </remarks>
+struct ThreadPoolConfig
+{
+	/// <summary>
+	/// number of threads in the pool
+	/// </summary>
+	unsigned int threadCount = thread::hardware_concurrency();
+
+	/// <summary>
+	/// processors of threads, thread i is pinned to cpus[i % cpus.size()],
+	/// if empty threads are not pinned
+	/// </summary>
+	vector<unsigned int> cpus;
+
+	/// <summary>
+	/// NUMA node of threads, thread i takes tasks from the queue of node numaNodes[i % numaNodes.size()],
+	/// if empty all threads use one queue
+	/// </summary>
+	vector<unsigned int> numaNodes;
+
+	/// <summary>
+	/// size in bytes of scratch memory allocated by every thread for itself,
+	/// 0 if threads do not need scratch memory,
+	/// only this part is guaranteed to be local to NUMA node of the thread
+	/// </summary>
+	size_t scratchSize = 0;
+
+	/// <summary>
+	/// config with one pinned thread per processor of NUMA node,
+	/// it is used to create one pool per socket
+	/// </summary>
+	/// <param name="numaNode">id of NUMA node</param>
+	/// <returns>config of pool, default config if node is not found</returns>
+	static ThreadPoolConfig forNumaNode(unsigned int numaNode);
+
+	/// <summary>
+	/// config with pinned threads on all processors,
+	/// every thread uses queue of its NUMA node
+	/// </summary>
+	/// <returns>config of pool</returns>
+	static ThreadPoolConfig numaAware();
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of NUMA nodes in the system</returns>
+	static unsigned int numaNodeCount();
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="numaNode">id of NUMA node</param>
+	/// <returns>processors of NUMA node, processors not allowed for the process are included</returns>
+	static vector<unsigned int> numaNodeCpus(unsigned int numaNode);
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>processors where the process is allowed to run, empty if it is not known</returns>
+	static vector<unsigned int> allowedCpus();
+};
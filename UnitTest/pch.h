@@ -8,16 +8,24 @@
 #include "gtest/gtest.h"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <map>
 #include <set>
 #include <functional>
 #include <unordered_map>
 #include <tuple>
 #include <limits>
+#include <cstdint>
+#include <cmath>
 #include <deque>
+#include <list>
 #include <mutex>
 #include <future>
 #include <queue>
 #include <utility>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <chrono>
 #include "../types.h"
 using namespace std;
\ No newline at end of file
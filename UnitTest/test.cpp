@@ -1,6 +1,16 @@
 #include "pch.h"
 #include "../Algorithms.h"
 #include "../ThreadPool.h"
+#include "../GraphArena.h"
+#include "../AsyncQuery.h"
+#include "../ShortestPathCache.h"
+#include "../PartitionOverlay.h"
+#include "../BfsEngine.h"
+#include "../ReachabilityIndex.h"
+#include "../QueueBellmanFord.h"
+#include "../CostQuantisation.h"
+#include "../BetweennessCentrality.h"
+#include "../MinimumSpanningForest.h"
 #include <algorithm> 
 #include "MemoryLeakDetector.h"
 
@@ -120,6 +130,943 @@ TEST_F(AlgorithmsUnit, dijkstra2) {
 	ASSERT_EQ(path[2], 3);
 }
 
+TEST_F(AlgorithmsUnit, graphArena) {
+
+	GraphArena<int> arena(5);
+
+	//lists of neighbours are allocated from the arena, default resource would throw
+	auto defaultResource = pmr::set_default_resource(pmr::null_memory_resource());
+	bool allocatedInArena = true;
+
+	try {
+		arena.addNeighbour(0, 1, 10);
+		arena.addNeighbour(0, 4, 5);
+
+		arena.addNeighbour(1, 2, 1);
+		arena.addNeighbour(1, 4, 2);
+
+		arena.addNeighbour(2, 3, 4);
+
+		arena.addNeighbour(3, 0, 7);
+		arena.addNeighbour(3, 2, 6);
+
+		arena.reserveNeighbours(4, 3);
+		arena.addNeighbour(4, 1, 3);
+		arena.addNeighbour(4, 2, 9);
+		arena.addNeighbour(4, 3, 2);
+	}
+	catch (const bad_alloc&) {
+		allocatedInArena = false;
+	}
+	pmr::set_default_resource(defaultResource);
+
+	ASSERT_TRUE(allocatedInArena);
+	ASSERT_EQ(arena.getNode(4).size(), 3);
+	ASSERT_EQ(arena.getNode(4).begin()->id, 1);
+
+	const auto& [path, cost] = dijstraShortestPath(arena, 0, 3);
+
+	ASSERT_EQ(cost, 7);
+
+	ASSERT_EQ(path.size(), 3);
+
+	ASSERT_EQ(path[0], 0);
+	ASSERT_EQ(path[1], 4);
+	ASSERT_EQ(path[2], 3);
+}
+
+TEST_F(AlgorithmsUnit, asyncQuery) {
+
+	vector<shared_ptr<NodeInPath<int>>> graf(4);
+
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+
+	graf[0]->addNeighbour(graf[1], 1);
+	graf[1]->addNeighbour(graf[2], 1);
+	graf[2]->addNeighbour(graf[3], 1);
+	graf[0]->addNeighbour(graf[3], 5);
+
+	ThreadPool pool;
+	{
+		auto control = make_shared<QueryControl>(chrono::steady_clock::now() + chrono::minutes(1));
+		const auto& [path, cost] = dijstraShortestPathAsync(pool, graf, 0, 3, control).get();
+
+		ASSERT_EQ(control->getStatus(), QueryStatus::completed);
+		ASSERT_EQ(cost, 3);
+		ASSERT_EQ(path.size(), 4);
+	}
+	{
+		auto control = make_shared<QueryControl>();
+		control->cancel();
+		const auto& [path, cost] = dijstraShortestPathAsync(pool, graf, 0, 3, control).get();
+
+		ASSERT_EQ(control->getStatus(), QueryStatus::cancelled);
+		ASSERT_EQ(cost, numeric_limits<int>::max());
+	}
+	{
+		auto control = make_shared<QueryControl>(chrono::steady_clock::now() - chrono::seconds(1), 1);
+		const auto& [path, cost] = bellmanFordShortestPathAsync(pool, graf, 0, 3, control).get();
+
+		ASSERT_EQ(control->getStatus(), QueryStatus::timedOut);
+		ASSERT_EQ(cost, numeric_limits<int>::max());
+	}
+
+	//long chain, the search is cancelled from this thread while it runs in the pool
+	const id_t size = 20000;
+	vector<shared_ptr<NodeInPath<int>>> chain(size);
+
+	for (id_t i = 0; i < size; i++) {
+		chain[i] = make_shared<NodeInPath<int>>(i);
+	}
+	for (id_t i = 0; i + 1 < size; i++) {
+		chain[i]->addNeighbour(chain[i + 1], 1);
+	}
+
+	ThreadPoolConfig config;
+	config.threadCount = 1;
+	ThreadPool singlePool(config);
+	{
+		auto control = make_shared<QueryControl>(16);
+		auto result = dijstraShortestPathAsync(singlePool, chain, 0, size - 1, control);
+
+		//the only thread of pool is busy when the search has started
+		while (!singlePool.isFull() && control->getStatus() == QueryStatus::running) {
+			this_thread::yield();
+		}
+		control->cancel();
+
+		const auto& [path, cost] = result.get();
+
+		ASSERT_EQ(control->getStatus(), QueryStatus::cancelled);
+		ASSERT_EQ(cost, numeric_limits<int>::max());
+		ASSERT_EQ(path.size(), 1);
+	}
+}
+
+TEST_F(AlgorithmsUnit, shortestPathCache) {
+
+	vector<shared_ptr<NodeInPath<int>>> graf(5);
+
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+
+	graf[0]->addNeighbour(graf[1], 10);
+	graf[0]->addNeighbour(graf[4], 5);
+	graf[1]->addNeighbour(graf[2], 1);
+	graf[2]->addNeighbour(graf[3], 4);
+	graf[4]->addNeighbour(graf[1], 3);
+	graf[4]->addNeighbour(graf[3], 9);
+
+	auto treeSize = dijstraShortestPathTree(graf, 0).getMemorySize();
+
+	//budget for one tree only
+	ShortestPathCache<int> cache(graf, treeSize, 1);
+	{
+		const auto& [path, cost] = cache.shortestPath(0, 3);
+
+		ASSERT_EQ(cost, 13);
+		ASSERT_EQ(path.size(), 5);
+		ASSERT_EQ(path[1], 4);
+	}
+
+	ASSERT_EQ(cache.getTree(0), cache.getTree(0));
+	ASSERT_EQ(cache.getMemoryUsage(), treeSize);
+
+	//change of graph invalidates the tree
+	auto oldTree = cache.getTree(0);
+	graf[0]->addNeighbour(graf[3], 1);
+	ASSERT_NE(cache.getTree(0), oldTree);
+	{
+		const auto& [path, cost] = cache.shortestPath(0, 3);
+
+		ASSERT_EQ(cost, 1);
+		ASSERT_EQ(path.size(), 2);
+	}
+
+	//second tree removes the first one
+	oldTree = cache.getTree(0);
+	cache.getTree(1);
+	ASSERT_EQ(cache.getMemoryUsage(), treeSize);
+	ASSERT_NE(cache.getTree(0), oldTree);
+}
+
+TEST_F(AlgorithmsUnit, partitionOverlay) {
+
+	//grid 6x6 with edges in both directions
+	const id_t side = 6;
+	vector<edge_t<int>> edges;
+
+	for (id_t row = 0; row < side; row++) {
+		for (id_t col = 0; col < side; col++) {
+			auto id = row * side + col;
+			if (col + 1 < side) {
+				edges.push_back(edge_t<int>(id, id + 1, 1 + id % 3));
+				edges.push_back(edge_t<int>(id + 1, id, 2));
+			}
+			if (row + 1 < side) {
+				edges.push_back(edge_t<int>(id, id + side, 1 + id % 5));
+				edges.push_back(edge_t<int>(id + side, id, 3));
+			}
+		}
+	}
+
+	FlatGraph<int> flat(side * side, edges);
+	ThreadPool pool;
+	PartitionOverlay<int> overlay(flat, 8, pool);
+
+	ASSERT_GT(overlay.getCellCount(), 1);
+
+	auto checkAllPaths = [&]() {
+		vector<shared_ptr<NodeInPath<int>>> graf(flat.getNodeCount());
+
+		for (unsigned int i = 0; i < graf.size(); i++) {
+			graf[i] = make_shared<NodeInPath<int>>(i);
+		}
+		for (const auto& [from, to, cost] : edges) {
+			graf[from]->addNeighbour(graf[to], cost);
+		}
+
+		for (id_t start = 0; start < graf.size(); start++) {
+			auto tree = dijstraShortestPathTree(graf, start);
+
+			for (id_t end = 0; end < graf.size(); end++) {
+				const auto& [path, cost] = overlay.shortestPath(start, end);
+
+				ASSERT_EQ(cost, tree.getCost(end));
+				ASSERT_EQ(path.front(), start);
+				ASSERT_EQ(path.back(), end);
+
+				int pathCost = 0;
+				for (size_t i = 1; i < path.size(); i++) {
+					auto edge = find_if(edges.begin(), edges.end(), [&](const edge_t<int>& e) {
+						return get<0>(e) == path[i - 1] && get<1>(e) == path[i];
+						});
+					ASSERT_NE(edge, edges.end());
+					pathCost += get<2>(*edge);
+				}
+				ASSERT_EQ(pathCost, cost);
+			}
+		}
+	};
+
+	checkAllPaths();
+
+	for (auto& [from, to, cost] : edges) {
+		if ((from + to) % 4 == 1) {
+			cost += 7;
+			ASSERT_TRUE(overlay.setCost(from, to, cost));
+		}
+	}
+	//missing edge is reported and no cell is changed
+	ASSERT_FALSE(overlay.setCost(0, side * side - 1, 1));
+	overlay.customize();
+
+	checkAllPaths();
+}
+
+TEST_F(AlgorithmsUnit, bfsEngine) {
+
+	//random graph with unit costs, the last node is not reachable
+	const unsigned int size = 3000;
+	vector<shared_ptr<NodeInPath<int>>> graf(size);
+	mt19937 random(7);
+
+	for (id_t id = 0; id < size; id++) {
+		graf[id] = make_shared<NodeInPath<int>>(id);
+	}
+	for (id_t id = 0; id + 1 < size; id++) {
+		for (int i = 0; i < 8; i++) {
+			graf[id]->addNeighbour(graf[random() % (size - 1)], 1);
+		}
+	}
+
+	//every step of path must be an edge of graph
+	FlatGraph<int> flat(graf);
+	auto isPathOfEdges = [&flat](const deque<id_t>& path) {
+		for (size_t i = 1; i < path.size(); i++) {
+			auto targets = flat.getTargets().begin();
+			if (find(targets + flat.firstEdge(path[i - 1]), targets + flat.lastEdge(path[i - 1]), path[i]) == targets + flat.lastEdge(path[i - 1])) {
+				return false;
+			}
+		}
+		return true;
+	};
+
+	//small tasks, so frontier of 47 words is scanned by more tasks
+	ThreadPoolConfig config;
+	config.threadCount = 4;
+	ThreadPool pool(config);
+	BfsEngine<int> engine(graf);
+	BfsEngine<int> parallelEngine(graf, &pool, 4);
+
+	for (id_t start : {0u, 17u, 2500u}) {
+		auto tree = dijstraShortestPathTree(graf, start);
+
+		for (id_t end = 0; end < size; end += 7) {
+			const auto& [path, cost] = engine.shortestPath(start, end);
+			const auto& [parallelPath, parallelCost] = parallelEngine.shortestPath(start, end);
+
+			ASSERT_EQ(cost, tree.getCost(end));
+			ASSERT_EQ(parallelCost, tree.getCost(end));
+			ASSERT_EQ(path.back(), end);
+			ASSERT_EQ(parallelPath.front(), start);
+			ASSERT_TRUE(start == end || parallelEngine.getSubmittedTaskCount() > 1);
+
+			if (cost != numeric_limits<int>::max()) {
+				ASSERT_EQ(path.size(), cost + 1);
+				ASSERT_EQ(parallelPath.size(), cost + 1);
+				ASSERT_TRUE(isPathOfEdges(path));
+				ASSERT_TRUE(isPathOfEdges(parallelPath));
+			}
+		}
+	}
+
+	const auto& [path, cost] = bfsShortestPath(graf, 0, size - 1);
+
+	ASSERT_EQ(cost, numeric_limits<int>::max());
+	ASSERT_EQ(path.size(), 1);
+}
+
+TEST_F(AlgorithmsUnit, threadPoolConfig) {
+
+	//first processor allowed for this process
+	auto allowedCpus = ThreadPoolConfig::allowedCpus();
+	ASSERT_FALSE(allowedCpus.empty());
+
+	ThreadPoolConfig config;
+	config.threadCount = 2;
+	config.cpus = { allowedCpus.front() };
+	config.numaNodes = { 0, 1 };
+	config.scratchSize = 1 << 16;
+
+	//independent pools in one process
+	ThreadPool pool(config);
+	ThreadPool otherPool(ThreadPoolConfig::forNumaNode(0));
+
+	ASSERT_EQ(pool.getThreadCount(), 2);
+	ASSERT_EQ(pool.getQueueCount(), 2);
+	ASSERT_EQ(pool.getUnpinnedThreadCount(), 0);
+	ASSERT_GE(otherPool.getThreadCount(), 1);
+	ASSERT_EQ(otherPool.getQueueCount(), 1);
+
+	//node without threads has no queue, its tasks go to queues with threads
+	ThreadPoolConfig sparseConfig;
+	sparseConfig.threadCount = 1;
+	sparseConfig.numaNodes = { 3, 1 };
+	ThreadPool sparsePool(sparseConfig);
+
+	ASSERT_EQ(sparsePool.getQueueCount(), 1);
+	sparsePool.submit([]() {}, 1).get();
+	sparsePool.submit([]() {}).get();
+	ASSERT_EQ(ThreadPool::getScratch(), nullptr);
+
+	auto useScratch = []() {
+		auto scratch = ThreadPool::getScratch();
+		if (scratch == nullptr) {
+			return 0;
+		}
+		pmr::vector<int> values(100, 1, scratch);
+		return static_cast<int>(values.size());
+	};
+
+	auto first = pool.submit<int>(useScratch);
+	auto second = pool.submit<int>(useScratch);
+	auto onNode = pool.submit([]() { ASSERT_NE(ThreadPool::getScratch(), nullptr); }, 1);
+	auto other = otherPool.submit<int>(useScratch);
+
+	ASSERT_EQ(first.get(), 100);
+	ASSERT_EQ(second.get(), 100);
+	ASSERT_EQ(other.get(), 0);
+	onNode.get();
+}
+
+TEST_F(AlgorithmsUnit, simdRelaxation) {
+
+	mt19937 random(11);
+	const id_t size = 1000;
+	vector<id_t> targets(37);
+	vector<int> weights(targets.size());
+
+	for (size_t i = 0; i < targets.size(); i++) {
+		//neighbours are duplicated to check lanes with the same node
+		targets[i] = random() % 20;
+		weights[i] = random() % 50;
+	}
+
+	vector<SimdLevel> levels{ SimdLevel::scalar };
+	if (getSimdLevel() != SimdLevel::scalar) {
+		levels.push_back(SimdLevel::avx2);
+	}
+	if (getSimdLevel() == SimdLevel::avx512) {
+		levels.push_back(SimdLevel::avx512);
+	}
+
+	vector<int> expectedCosts;
+	for (auto level : levels) {
+		vector<int> costs(size, 30);
+		relaxEdges(targets.data(), weights.data(), targets.size(), 5, costs.data(), [](id_t, int) {}, level);
+
+		if (expectedCosts.empty()) {
+			expectedCosts = costs;
+		}
+		ASSERT_EQ(costs, expectedCosts);
+	}
+
+	//the same graph with int and float costs
+	vector<edge_t<int>> edges;
+	vector<edge_t<float>> floatEdges;
+	for (id_t id = 0; id < size; id++) {
+		for (int i = 0; i < 40; i++) {
+			auto neigbourId = static_cast<id_t>(random() % size);
+			auto cost = static_cast<int>(random() % 100);
+			edges.push_back(edge_t<int>(id, neigbourId, cost));
+			floatEdges.push_back(edge_t<float>(id, neigbourId, static_cast<float>(cost)));
+		}
+	}
+
+	FlatGraph<int> flat(size, edges);
+	FlatGraph<float> floatFlat(size, floatEdges);
+
+	vector<shared_ptr<NodeInPath<int>>> graf(size);
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+	for (const auto& [from, to, cost] : edges) {
+		graf[from]->addNeighbour(graf[to], cost);
+	}
+
+	auto tree = dijstraShortestPathTree(graf, 0);
+
+	for (id_t end = 0; end < size; end += 13) {
+		const auto& [path, cost] = dijstraShortestPath(flat, 0, end);
+		const auto& [floatPath, floatCost] = dijstraShortestPath(floatFlat, 0, end);
+
+		ASSERT_EQ(cost, tree.getCost(end));
+		ASSERT_EQ(floatCost, static_cast<float>(tree.getCost(end)));
+		ASSERT_EQ(path.front(), 0);
+		ASSERT_EQ(floatPath.back(), end);
+	}
+}
+
+TEST_F(AlgorithmsUnit, compressedGraph) {
+
+	mt19937 random(5);
+	const id_t size = 2000;
+	vector<edge_t<int>> edges;
+	vector<edge_t<double>> doubleEdges;
+
+	for (id_t id = 0; id < size; id++) {
+		for (int i = 0; i < 30; i++) {
+			//most neighbours are close to the node
+			auto neigbourId = static_cast<id_t>(i % 3 == 0 ? random() % size : (id + random() % 200) % size);
+			auto cost = static_cast<int>(random() % 100);
+			edges.push_back(edge_t<int>(id, neigbourId, cost));
+			doubleEdges.push_back(edge_t<double>(id, neigbourId, cost + 0.37));
+		}
+	}
+
+	FlatGraph<int> flat(size, edges);
+	CompressedGraph<int> compressed(flat);
+
+	ASSERT_EQ(compressed.getEdgeCount(), edges.size());
+	ASSERT_LT(compressed.getMemorySize(), 4 * edges.size());
+	ASSERT_EQ(compressed.getMaxQuantisationError(), 0);
+
+	//integral costs with bigger range get more bits by default
+	auto wideEdges = edges;
+	get<2>(wideEdges.front()) = 100000;
+	CompressedGraph<int> wide(FlatGraph<int>(size, wideEdges));
+
+	ASSERT_EQ(wide.getWeightBits(), 17);
+	ASSERT_EQ(wide.getMaxQuantisationError(), 0);
+	ASSERT_EQ(CompressedGraph<int>(FlatGraph<int>(size, wideEdges), 8).getWeightBits(), 8);
+	ASSERT_GT(CompressedGraph<int>(FlatGraph<int>(size, wideEdges), 8).getMaxQuantisationError(), 0);
+
+	for (id_t end = 0; end < size; end += 17) {
+		const auto& [path, cost] = dijstraShortestPath(compressed, 3, end);
+		const auto& [flatPath, flatCost] = dijstraShortestPath(flat, 3, end);
+
+		ASSERT_EQ(cost, flatCost);
+		ASSERT_EQ(path.front(), 3);
+		ASSERT_EQ(path.back(), end);
+	}
+
+	//costs with fraction are rounded to 4 bits
+	CompressedGraph<double> quantised(FlatGraph<double>(size, doubleEdges), 4);
+	auto step = 99.0 / 15;
+
+	ASSERT_GT(quantised.getMaxQuantisationError(), 0);
+	ASSERT_LE(quantised.getMaxQuantisationError(), step / 2 + 1e-9);
+
+	size_t neighbourCount = 0;
+	auto decoder = quantised.neighbours(0);
+	id_t neigbourId;
+	double cost;
+	while (decoder.next(neigbourId, cost)) {
+		neighbourCount++;
+	}
+	ASSERT_EQ(neighbourCount, 30);
+}
+
+TEST_F(AlgorithmsUnit, reachabilityIndex) {
+	vector<shared_ptr<NodeInPath<int>>> graf(6);
+
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+
+	graf[0]->addNeighbour(graf[1], 1);
+	graf[1]->addNeighbour(graf[2], 1);
+	graf[2]->addNeighbour(graf[0], 1);
+	graf[2]->addNeighbour(graf[3], 4);
+	graf[3]->addNeighbour(graf[4], 1);
+	graf[4]->addNeighbour(graf[3], 1);
+
+	ReachabilityIndex small(graf);
+
+	ASSERT_EQ(small.getComponentCount(), 3);
+	ASSERT_EQ(small.getComponent(0), small.getComponent(2));
+	ASSERT_FALSE(small.isUnreachable(0, 4));
+	ASSERT_TRUE(small.isUnreachable(3, 0));
+	ASSERT_TRUE(small.isUnreachable(5, 0));
+
+	const auto& [path, cost] = dijstraShortestPath(graf, small, 1, 4);
+	ASSERT_EQ(cost, 6);
+	ASSERT_EQ(path.size(), 4);
+
+	const auto& [noPath, noCost] = dijstraShortestPath(graf, small, 4, 1);
+	ASSERT_EQ(noCost, numeric_limits<int>::max());
+	ASSERT_EQ(noPath.size(), 1);
+
+	//clusters are cycles, edges betwean clusters go only forward
+	mt19937 random(11);
+	const id_t clusterSize = 50;
+	const id_t clusterCount = 200;
+	const id_t size = clusterSize * clusterCount + 100;
+	vector<edge_t<int>> edges;
+
+	for (id_t cluster = 0; cluster < clusterCount; cluster++) {
+		auto first = cluster * clusterSize;
+
+		for (id_t i = 0; i < clusterSize; i++) {
+			edges.push_back(edge_t<int>(first + i, first + (i + 1) % clusterSize, 1 + random() % 10));
+			edges.push_back(edge_t<int>(first + i, first + random() % clusterSize, 1 + random() % 10));
+		}
+		if (cluster + 1 < clusterCount && random() % 2 == 0) {
+			auto next = cluster + 1 + random() % min<id_t>(5, clusterCount - cluster - 1);
+			edges.push_back(edge_t<int>(first + random() % clusterSize, next * clusterSize + random() % clusterSize, 3));
+		}
+	}
+	//single nodes at the end are removed by trimming
+	for (id_t id = clusterSize * clusterCount; id < size; id++) {
+		edges.push_back(edge_t<int>(id, random() % (clusterSize * clusterCount), 2));
+	}
+
+	FlatGraph<int> flat(size, edges);
+	ThreadPool threadPool;
+	ReachabilityIndex sequential(flat);
+	ReachabilityIndex parallel(flat, &threadPool);
+
+	ASSERT_EQ(sequential.getComponentCount(), clusterCount + 100);
+	ASSERT_EQ(parallel.getComponentCount(), clusterCount + 100);
+
+	size_t provedUnreachable = 0;
+	for (int i = 0; i < 300; i++) {
+		auto start = static_cast<id_t>(random() % size);
+		auto end = static_cast<id_t>(random() % size);
+
+		ASSERT_EQ(sequential.getComponent(start) == sequential.getComponent(end),
+			parallel.getComponent(start) == parallel.getComponent(end));
+
+		const auto& [flatPath, flatCost] = dijstraShortestPath(flat, start, end);
+		const auto& [indexPath, indexCost] = dijstraShortestPath(flat, parallel, start, end);
+		ASSERT_EQ(flatCost, indexCost);
+
+		if (parallel.isUnreachable(start, end)) {
+			ASSERT_EQ(flatCost, numeric_limits<int>::max());
+			provedUnreachable++;
+		}
+		ASSERT_EQ(sequential.isUnreachable(start, end) && flatCost != numeric_limits<int>::max(), false);
+	}
+	ASSERT_GT(provedUnreachable, 150);
+}
+
+TEST_F(AlgorithmsUnit, queueBellmanFord) {
+	vector<shared_ptr<NodeInPath<int>>> graf(5);
+
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+
+	graf[0]->addNeighbour(graf[1], 4);
+	graf[0]->addNeighbour(graf[2], 1);
+	graf[2]->addNeighbour(graf[1], -2);
+	graf[1]->addNeighbour(graf[3], 3);
+	graf[3]->addNeighbour(graf[4], -1);
+
+	const auto& [path, cost, cycle] = queueBellmanFordShortestPath(graf, 0, 4);
+
+	ASSERT_EQ(cost, 1);
+	ASSERT_EQ(path, deque<id_t>({ 0, 2, 1, 3, 4 }));
+	ASSERT_TRUE(cycle.empty());
+
+	//edge 4->2 closes cycle 2, 1, 3, 4 with cost -1
+	graf[4]->addNeighbour(graf[2], -1);
+
+	const auto& [cyclePath, cycleCost, negativeCycle] = queueBellmanFordShortestPath(graf, 0, 4);
+
+	ASSERT_TRUE(cyclePath.empty());
+	ASSERT_EQ(cycleCost, numeric_limits<int>::min());
+	ASSERT_EQ(negativeCycle.size(), 4);
+	ASSERT_EQ(set<id_t>(negativeCycle.begin(), negativeCycle.end()), set<id_t>({ 1, 2, 3, 4 }));
+
+	//negative costs are made from nonnegative costs and potentials, shortest paths stay the same
+	mt19937 random(13);
+	const id_t size = 3000;
+	vector<int> potentials(size);
+	vector<edge_t<int>> edges;
+	vector<edge_t<int>> negativeEdges;
+
+	for (auto& potential : potentials) {
+		potential = static_cast<int>(random() % 50);
+	}
+	for (id_t id = 0; id < size; id++) {
+		for (int i = 0; i < 5; i++) {
+			auto neigbourId = static_cast<id_t>(random() % size);
+			auto edgeCost = static_cast<int>(random() % 20);
+			edges.push_back(edge_t<int>(id, neigbourId, edgeCost));
+			negativeEdges.push_back(edge_t<int>(id, neigbourId, edgeCost + potentials[id] - potentials[neigbourId]));
+		}
+	}
+
+	FlatGraph<int> flat(size, edges);
+	FlatGraph<int> negativeFlat(size, negativeEdges);
+
+	for (id_t end = 0; end < size; end += 97) {
+		const auto& [flatPath, flatCost] = dijstraShortestPath(flat, 0, end);
+		const auto& [negativePath, negativeCost, noCycle] = queueBellmanFordShortestPath(negativeFlat, 0, end);
+
+		ASSERT_TRUE(noCycle.empty());
+		if (flatCost == numeric_limits<int>::max()) {
+			ASSERT_EQ(negativeCost, numeric_limits<int>::max());
+		}
+		else {
+			ASSERT_EQ(negativeCost, flatCost + potentials[0] - potentials[end]);
+			ASSERT_EQ(negativePath.front(), 0);
+			ASSERT_EQ(negativePath.back(), end);
+		}
+	}
+
+	//long chain does not need deep recursion
+	const id_t chainSize = 200000;
+	vector<edge_t<int>> chain;
+	for (id_t id = 0; id + 1 < chainSize; id++) {
+		chain.push_back(edge_t<int>(id, id + 1, id % 2 == 0 ? -1 : 2));
+	}
+
+	const auto& [chainPath, chainCost, chainCycle] = queueBellmanFordShortestPath(FlatGraph<int>(chainSize, chain), 0, chainSize - 1);
+	ASSERT_EQ(chainPath.size(), chainSize);
+	ASSERT_EQ(chainCost, 2 * (chainSize / 2 - 1) - chainSize / 2);
+}
+
+TEST_F(AlgorithmsUnit, fixedCost) {
+	using Time = Fixed<uint32_t, 1000>;
+	using Difference = Fixed<int32_t, 100>;
+
+	ASSERT_EQ(sizeof(Time), 4);
+	ASSERT_EQ(Time(3) + Time(2), Time(5));
+	ASSERT_EQ(Time(2.0005).getRaw(), 2001);
+	ASSERT_EQ(numeric_limits<Time>::max() + Time(5), numeric_limits<Time>::max());
+	ASSERT_EQ(Time::fromRaw(numeric_limits<uint32_t>::max() - 1) + Time(1), numeric_limits<Time>::max());
+	ASSERT_EQ(Time(2) - Time(5), Time(0));
+	ASSERT_EQ(Difference(2) - Difference(5), Difference(-3));
+	ASSERT_EQ(numeric_limits<Difference>::lowest() + Difference(-1), numeric_limits<Difference>::lowest());
+	ASSERT_EQ(static_cast<double>(Difference(-1.25)), -1.25);
+
+	mt19937 random(17);
+	const id_t size = 1000;
+	vector<shared_ptr<NodeInPath<double>>> graf(size);
+
+	for (id_t i = 0; i < size; i++) {
+		graf[i] = make_shared<NodeInPath<double>>(i);
+	}
+	for (id_t i = 0; i < size; i++) {
+		for (int j = 0; j < 4; j++) {
+			graf[i]->addNeighbour(graf[random() % size], (random() % 100000) / 997.0);
+		}
+	}
+
+	const auto& [timeGraf, maxError] = quantiseCosts<Time>(graf);
+	const auto& [timeFlat, maxFlatError] = quantiseCosts<Time>(FlatGraph<double>(graf));
+
+	ASSERT_GT(maxError, 0);
+	ASSERT_LE(maxError, 0.0005 + 1e-9);
+	ASSERT_EQ(maxError, maxFlatError);
+
+	for (id_t end = 0; end < size; end += 37) {
+		const auto& [path, cost] = dijstraShortestPath(graf, 0, end);
+		const auto& [timePath, timeCost] = dijstraShortestPath(timeGraf, 0, end);
+		const auto& [flatPath, flatCost] = dijstraShortestPath(timeFlat, 0, end);
+		const auto& [queuePath, queueCost, cycle] = queueBellmanFordShortestPath(timeFlat, 0, end);
+
+		ASSERT_EQ(timeCost, flatCost);
+		ASSERT_EQ(timeCost, queueCost);
+		if (cost == numeric_limits<double>::max()) {
+			ASSERT_EQ(timeCost, numeric_limits<Time>::max());
+		}
+		else {
+			ASSERT_NEAR(static_cast<double>(timeCost), cost, maxError * path.size());
+		}
+	}
+}
+
+TEST_F(AlgorithmsUnit, versionedGraph) {
+	//chain with two changed edges in different blocks, version v has cost of the path size - 3 + 2 * (v + 1)
+	const id_t size = 2000;
+	const id_t changed = 1500;
+	VersionedGraph<int> graph(size, 128);
+
+	{
+		auto update = graph.beginUpdate();
+		for (id_t id = 0; id + 1 < size; id++) {
+			update.addNeighbour(id, id + 1, 1);
+		}
+		update.publish();
+	}
+
+	auto first = graph.getSnapshot();
+	ASSERT_EQ(first->getVersion(), 1);
+	ASSERT_EQ(get<1>(dijstraShortestPath(*first, 0, size - 1)), size - 1);
+
+	atomic_bool stop = false;
+	atomic_int queries = 0;
+	atomic_int errors = 0;
+	vector<thread> readers;
+
+	for (int i = 0; i < 3; i++) {
+		readers.push_back(thread([&graph, &stop, &queries, &errors]() {
+			while (!stop || queries < 10) {
+				auto snapshot = graph.getSnapshot();
+				const auto& [path, cost] = dijstraShortestPath(*snapshot, 0, size - 1);
+				auto version = static_cast<int>(snapshot->getVersion());
+
+				if (path.size() != size || cost != static_cast<int>(size) - 3 + 2 * version) {
+					errors++;
+				}
+				queries++;
+			}
+		}));
+	}
+
+	for (int version = 2; version <= 50; version++) {
+		auto change = graph.beginUpdate();
+		ASSERT_TRUE(change.setCost(0, 1, version));
+		ASSERT_TRUE(change.setCost(changed, changed + 1, version));
+		change.publish();
+	}
+	stop = true;
+
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	ASSERT_EQ(errors, 0);
+
+	//old snapshot is not changed, unchanged blocks are shared
+	auto last = graph.getSnapshot();
+	ASSERT_EQ(last->getVersion(), 50);
+	ASSERT_EQ(get<1>(dijstraShortestPath(*first, 0, size - 1)), size - 1);
+	ASSERT_EQ(get<1>(dijstraShortestPath(graph, 0, size - 1)), size - 3 + 2 * 50);
+	ASSERT_EQ(first->getBlocks()[5], last->getBlocks()[5]);
+	ASSERT_NE(first->getBlocks()[0], last->getBlocks()[0]);
+
+	//versions replaced after the oldest reader started are kept until it releases its snapshot
+	ASSERT_EQ(graph.getRetiredCount(), 49);
+	first.reset();
+	graph.reclaim();
+	ASSERT_EQ(graph.getRetiredCount(), 0);
+
+	//new node and removed edge are not visible in held snapshot
+	id_t id;
+	{
+		auto change = graph.beginUpdate();
+		id = change.addNode();
+		change.addNeighbour(0, id, 1);
+		change.addNeighbour(id, size - 1, 1);
+		ASSERT_TRUE(change.removeNeighbour(changed, changed + 1));
+		ASSERT_FALSE(change.removeNeighbour(changed, changed + 1));
+		ASSERT_EQ(change.publish(), 51);
+	}
+
+	ASSERT_EQ(id, size);
+	ASSERT_EQ(last->getNodeCount(), size);
+	ASSERT_EQ(graph.getSnapshot()->getNodeCount(), size + 1);
+	ASSERT_EQ(get<1>(dijstraShortestPath(graph, 0, size - 1)), 2);
+	ASSERT_EQ(get<1>(dijstraShortestPath(graph, 1, size - 1)), numeric_limits<int>::max());
+
+	//version held by last reader is not deleted, but it is deleted after release
+	ASSERT_EQ(graph.getRetiredCount(), 1);
+	last.reset();
+	graph.reclaim();
+	ASSERT_EQ(graph.getRetiredCount(), 0);
+
+	//one thread holds more snapshots than there are slots in the first table
+	vector<VersionedGraph<int>::SnapshotPtr> held;
+	for (int i = 0; i < 1000; i++) {
+		held.push_back(graph.getSnapshot());
+	}
+	graph.addNeighbour(1, 2, 5);
+
+	ASSERT_EQ(held.front()->getVersion(), 51);
+	ASSERT_EQ(held.back()->getVersion(), 51);
+	ASSERT_EQ(graph.getSnapshot()->getVersion(), 52);
+	ASSERT_EQ(graph.getRetiredCount(), 1);
+
+	held.clear();
+	graph.reclaim();
+	ASSERT_EQ(graph.getRetiredCount(), 0);
+}
+
+TEST_F(AlgorithmsUnit, betweennessCentrality) {
+	//diamond 0 -> 1, 2 -> 3 -> 4, both paths from 0 to 3 have the same cost
+	vector<edge_t<int>> diamondEdges{
+		edge_t<int>(0, 1, 1), edge_t<int>(0, 2, 2), edge_t<int>(1, 3, 2), edge_t<int>(2, 3, 1), edge_t<int>(3, 4, 1)
+	};
+	FlatGraph<int> diamond(5, diamondEdges);
+
+	auto weighted = betweennessCentrality(diamond);
+	ASSERT_DOUBLE_EQ(weighted[0], 0);
+	ASSERT_DOUBLE_EQ(weighted[1], 1);
+	ASSERT_DOUBLE_EQ(weighted[2], 1);
+	ASSERT_DOUBLE_EQ(weighted[3], 3);
+	ASSERT_DOUBLE_EQ(weighted[4], 0);
+
+	//cheaper path through 1 takes all paths
+	ASSERT_EQ(diamond.getTarget(1), 2);
+	diamond.setCost(1, 3);
+	auto cheaper = betweennessCentrality(diamond);
+	ASSERT_DOUBLE_EQ(cheaper[1], 2);
+	ASSERT_DOUBLE_EQ(cheaper[2], 0);
+
+	auto unweighted = betweennessCentrality(diamond, false);
+	ASSERT_DOUBLE_EQ(unweighted[1], 1);
+	ASSERT_DOUBLE_EQ(unweighted[2], 1);
+
+	//random graph: unit costs give the same result as unweighted search
+	mt19937 random(19);
+	const id_t size = 1500;
+	vector<edge_t<int>> edges;
+
+	for (id_t id = 0; id < size; id++) {
+		for (int i = 0; i < 4; i++) {
+			auto neigbourId = static_cast<id_t>(random() % size);
+			edges.push_back(edge_t<int>(id, neigbourId, 1));
+			edges.push_back(edge_t<int>(neigbourId, id, 1));
+		}
+	}
+
+	FlatGraph<int> flat(size, edges);
+	ThreadPool threadPool;
+
+	auto exact = betweennessCentrality(flat, false);
+	auto unitCosts = betweennessCentrality(flat, true, &threadPool);
+
+	for (id_t id = 0; id < size; id++) {
+		ASSERT_NEAR(exact[id], unitCosts[id], 1e-6 * (1 + exact[id]));
+	}
+
+	//sampled sources, error is relative to number of pairs
+	double maxError = 0.1;
+	auto sampleSize = betweennessSampleSize(size, maxError, 0.1);
+	ASSERT_LT(sampleSize, size);
+
+	auto approximate = approximateBetweennessCentrality(flat, maxError, 0.1, false, &threadPool);
+	auto pairs = static_cast<double>(size - 1) * (size - 2);
+
+	for (id_t id = 0; id < size; id++) {
+		ASSERT_LE(abs(approximate[id] - exact[id]) / pairs, maxError);
+	}
+}
+
+TEST_F(AlgorithmsUnit, minimumSpanningForest) {
+	vector<shared_ptr<NodeInPath<int>>> graf(6);
+
+	for (unsigned int i = 0; i < graf.size(); i++) {
+		graf[i] = make_shared<NodeInPath<int>>(i);
+	}
+
+	//two trees: 0, 1, 2, 3 and 4, 5
+	graf[0]->addNeighbour(graf[1], 4);
+	graf[1]->addNeighbour(graf[2], 2);
+	graf[2]->addNeighbour(graf[0], 1);
+	graf[3]->addNeighbour(graf[0], 7);
+	graf[2]->addNeighbour(graf[3], 3);
+	graf[4]->addNeighbour(graf[5], 5);
+	graf[5]->addNeighbour(graf[5], 1);
+
+	{
+		const auto& [edges, cost] = minimumSpanningForest(graf);
+
+		ASSERT_EQ(edges.size(), 4);
+		ASSERT_EQ(cost, 11);
+	}
+
+	//random graph with many edges of the same cost, compared with Kruskal algorithm
+	mt19937 random(23);
+	const id_t size = 20000;
+	vector<edge_t<int>> edges;
+
+	for (id_t id = 0; id < size; id++) {
+		for (int i = 0; i < 6; i++) {
+			//the last nodes are not connected with the rest
+			auto neigbourId = id < size - 100 ? static_cast<id_t>(random() % (size - 100)) : size - 100 + static_cast<id_t>(random() % 100);
+			edges.push_back(edge_t<int>(id, neigbourId, static_cast<int>(random() % 50)));
+		}
+	}
+
+	auto sortedEdges = edges;
+	stable_sort(sortedEdges.begin(), sortedEdges.end(),
+		[](const edge_t<int>& first, const edge_t<int>& second) { return get<2>(first) < get<2>(second); });
+
+	ConcurrentUnionFind kruskal(size);
+	int kruskalCost = 0;
+	size_t kruskalEdges = 0;
+	for (const auto& [from, to, cost] : sortedEdges) {
+		if (kruskal.unite(from, to)) {
+			kruskalCost += cost;
+			kruskalEdges++;
+		}
+	}
+
+	FlatGraph<int> flat(size, edges);
+	ThreadPool threadPool;
+	MinimumSpanningForest<int> sequential(flat);
+	const auto& [parallelEdges, parallelCost] = minimumSpanningForest(flat, &threadPool);
+
+	ASSERT_EQ(sequential.getCost(), kruskalCost);
+	ASSERT_EQ(sequential.getEdges().size(), kruskalEdges);
+	ASSERT_LT(sequential.getRoundCount(), 20);
+	ASSERT_EQ(parallelCost, kruskalCost);
+
+	//forest is the same for any number of threads
+	auto sequentialEdges = sequential.getEdges();
+	auto sortedParallelEdges = parallelEdges;
+	sort(sequentialEdges.begin(), sequentialEdges.end());
+	sort(sortedParallelEdges.begin(), sortedParallelEdges.end());
+	ASSERT_EQ(sequentialEdges, sortedParallelEdges);
+
+	//edges of forest connect all nodes of components
+	ConcurrentUnionFind forest(size);
+	for (const auto& [from, to, cost] : parallelEdges) {
+		ASSERT_TRUE(forest.unite(from, to));
+	}
+	for (id_t id = 0; id < size; id++) {
+		ASSERT_EQ(forest.find(id) == forest.find(0), kruskal.find(id) == kruskal.find(0));
+	}
+}
+
 TEST_F(AlgorithmsUnit, bellmanford) {
 	vector<shared_ptr<NodeInPath<int>>> graf(6);
 
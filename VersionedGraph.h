@@ -0,0 +1,640 @@
+#pragma once
+#include "NodeInPath.h"
+
+/// <summary>
+/// immutable version of graph, nodes are stored in blocks shared betwean versions
+/// </summary>
+/// <typeparm name="Cost_t">type of cost betwean two nodes</typeparm>
+/// <remarks>snapshot is never changed, so any number of threads can read it without locks</remarks>
+template <typename Cost_t>
+class GraphSnapshot
+{
+public:
+	using cost_type = Cost_t;
+
+	/// <summary>
+	/// neighbours of one node: id of neighbour and cost
+	/// </summary>
+	using Neighbours = vector<tuple<id_t, Cost_t>>;
+
+	/// <summary>
+	/// neighbours of blockSize following nodes
+	/// </summary>
+	struct Block {
+		vector<Neighbours> nodes;
+	};
+
+	/// <summary>
+	/// creates snapshot from blocks
+	/// </summary>
+	/// <param name="blocks">blocks of nodes, the last block can be smaller</param>
+	/// <param name="nodeCount">number of nodes</param>
+	/// <param name="blockSize">number of nodes in one block</param>
+	/// <param name="version">number of published updates before this snapshot</param>
+	GraphSnapshot(vector<shared_ptr<const Block>> blocks, id_t nodeCount, id_t blockSize, uint64_t version)
+		:blocks(move(blocks)), nodeCount(nodeCount), blockSize(blockSize), version(version) {}
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of nodes</returns>
+	id_t getNodeCount() const { return nodeCount; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of published updates before this snapshot</returns>
+	uint64_t getVersion() const { return version; }
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <returns>neighbours of the node</returns>
+	const Neighbours& getNeighbours(id_t id) const { return blocks[id / blockSize]->nodes[id % blockSize]; }
+
+	/// <summary>
+	/// calls function for every neighbour of node
+	/// </summary>
+	/// <param name="id">id of node</param>
+	/// <param name="func">function called with id of neighbour and cost</param>
+	template <typename Func_t>
+	void forEachNeighbour(id_t id, Func_t&& func) const;
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>blocks of nodes, unchanged blocks are shared with other versions</returns>
+	const vector<shared_ptr<const Block>>& getBlocks() const { return blocks; }
+
+private:
+	/// <summary>
+	/// blocks of nodes
+	/// </summary>
+	vector<shared_ptr<const Block>> blocks;
+
+	/// <summary>
+	/// number of nodes
+	/// </summary>
+	id_t nodeCount;
+
+	/// <summary>
+	/// number of nodes in one block
+	/// </summary>
+	id_t blockSize;
+
+	/// <summary>
+	/// number of published updates before this snapshot
+	/// </summary>
+	uint64_t version;
+};
+
+/// <summary>
+/// graph which can be changed while queries run: every query reads snapshot,
+/// writers build new version and publish it atomically
+/// </summary>
+/// <typeparm name="Cost_t">type of cost betwean two nodes</typeparm>
+/// <remarks>
+/// new version copies only changed blocks of nodes, other blocks are shared,
+/// old versions are reclaimed by epochs: reader announces the current epoch in its own slot,
+/// writer retires replaced version with the next epoch and deletes it when no reader announced older epoch,
+/// readers never write memory shared with other readers,
+/// when all slots are taken, for example by one thread which holds many snapshots,
+/// a twice bigger table of slots is added, tables are released only with the graph,
+/// every snapshot must be released before the graph is destroyed
+/// </remarks>
+template <typename Cost_t>
+class VersionedGraph
+{
+public:
+	using Snapshot = GraphSnapshot<Cost_t>;
+	using Block = typename Snapshot::Block;
+
+	/// <summary>
+	/// snapshot held by reader, old versions are not deleted while it exists
+	/// </summary>
+	class SnapshotPtr
+	{
+	public:
+		SnapshotPtr(SnapshotPtr&& other) noexcept
+			:slot(other.slot), snapshot(other.snapshot) { other.slot = nullptr; other.snapshot = nullptr; }
+
+		SnapshotPtr& operator=(SnapshotPtr&& other) noexcept;
+
+		SnapshotPtr(const SnapshotPtr&) = delete;
+		SnapshotPtr& operator=(const SnapshotPtr&) = delete;
+
+		~SnapshotPtr() { reset(); }
+
+		/// <summary>
+		/// releases snapshot, it must not be used any more
+		/// </summary>
+		void reset();
+
+		/// <summary>
+		///
+		/// </summary>
+		/// <returns>held snapshot, nullptr after reset</returns>
+		const Snapshot* get() const { return snapshot; }
+
+		const Snapshot& operator*() const { return *snapshot; }
+		const Snapshot* operator->() const { return snapshot; }
+
+	private:
+		friend class VersionedGraph;
+
+		SnapshotPtr(atomic<uint64_t>* slot, const Snapshot* snapshot)
+			:slot(slot), snapshot(snapshot) {}
+
+		/// <summary>
+		/// slot of reader with announced epoch
+		/// </summary>
+		atomic<uint64_t>* slot;
+
+		const Snapshot* snapshot;
+	};
+
+	/// <summary>
+	/// changes of graph, they are visible to queries after publish,
+	/// only one update can exist at the same time
+	/// </summary>
+	class Update
+	{
+	public:
+		/// <summary>
+		/// starts update, waits until other update is finished
+		/// </summary>
+		/// <param name="graph">changed graph</param>
+		Update(VersionedGraph& graph);
+
+		/// <summary>
+		/// adds node without neighbours
+		/// </summary>
+		/// <returns>id of new node</returns>
+		id_t addNode();
+
+		/// <summary>
+		/// add a neigbour node to selected node
+		/// </summary>
+		/// <param name="from">id of node</param>
+		/// <param name="to">id of neighbour node</param>
+		/// <param name="pathCost">cost connected with this neigbour</param>
+		void addNeighbour(id_t from, id_t to, Cost_t pathCost);
+
+		/// <summary>
+		/// changes cost of edges betwean two nodes
+		/// </summary>
+		/// <param name="from">id of node</param>
+		/// <param name="to">id of neighbour node</param>
+		/// <param name="pathCost">new cost</param>
+		/// <returns>false if there is no such edge</returns>
+		bool setCost(id_t from, id_t to, Cost_t pathCost);
+
+		/// <summary>
+		/// removes edges betwean two nodes
+		/// </summary>
+		/// <param name="from">id of node</param>
+		/// <param name="to">id of neighbour node</param>
+		/// <returns>false if there is no such edge</returns>
+		bool removeNeighbour(id_t from, id_t to);
+
+		/// <summary>
+		/// publishes new version and reclaims old versions which are not read any more,
+		/// next changes are copied again
+		/// </summary>
+		/// <returns>version of published snapshot</returns>
+		uint64_t publish();
+
+	private:
+		/// <summary>
+		/// copies block if it is shared with published version
+		/// </summary>
+		/// <param name="blockIndex">index of block</param>
+		/// <returns>block which can be changed</returns>
+		Block& getWritableBlock(size_t blockIndex);
+
+		/// <summary>
+		///
+		/// </summary>
+		/// <param name="id">id of node</param>
+		/// <returns>neighbours of the node which can be changed</returns>
+		typename Snapshot::Neighbours& getWritable(id_t id)
+		{
+			return getWritableBlock(id / graph.blockSize).nodes[id % graph.blockSize];
+		}
+
+		VersionedGraph& graph;
+
+		/// <summary>
+		/// only one writer changes the graph
+		/// </summary>
+		unique_lock<mutex> lock;
+
+		/// <summary>
+		/// blocks of new version
+		/// </summary>
+		vector<shared_ptr<const Block>> blocks;
+
+		/// <summary>
+		/// copied or created blocks, which are not published yet
+		/// </summary>
+		vector<shared_ptr<Block>> writableBlocks;
+
+		/// <summary>
+		/// number of nodes in new version
+		/// </summary>
+		id_t nodeCount;
+	};
+
+	/// <summary>
+	/// creates graph without edges
+	/// </summary>
+	/// <param name="size">number of nodes in graph</param>
+	/// <param name="blockSize">number of nodes copied together when one of them is changed</param>
+	VersionedGraph(id_t size, id_t blockSize = 256);
+
+	/// <summary>
+	/// copies graph made of nodes
+	/// </summary>
+	/// <param name="graph">definition of graph</param>
+	/// <param name="blockSize">number of nodes copied together when one of them is changed</param>
+	VersionedGraph(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, id_t blockSize = 256);
+
+	VersionedGraph(const VersionedGraph&) = delete;
+	VersionedGraph& operator=(const VersionedGraph&) = delete;
+
+	~VersionedGraph();
+
+	/// <summary>
+	/// returns the last published version, it stays valid while the pointer is held
+	/// </summary>
+	/// <returns>snapshot of graph</returns>
+	/// <remarks>reader claims free slot, announces epoch in it and loads the current version</remarks>
+	SnapshotPtr getSnapshot() const;
+
+	/// <summary>
+	/// starts update of graph
+	/// </summary>
+	/// <returns>update, changes are discarded if it is not published</returns>
+	Update beginUpdate() { return Update(*this); }
+
+	/// <summary>
+	/// adds one edge and publishes new version
+	/// </summary>
+	/// <param name="from">id of node</param>
+	/// <param name="to">id of neighbour node</param>
+	/// <param name="pathCost">cost connected with this neigbour</param>
+	void addNeighbour(id_t from, id_t to, Cost_t pathCost);
+
+	/// <summary>
+	/// deletes old versions which are not read any more, publish calls it too
+	/// </summary>
+	void reclaim();
+
+	/// <summary>
+	///
+	/// </summary>
+	/// <returns>number of replaced versions which are not deleted yet</returns>
+	size_t getRetiredCount();
+
+private:
+	/// <summary>
+	/// epoch announced by one reader, 0 if slot is free,
+	/// every slot has its own cache line
+	/// </summary>
+	struct alignas(64) ReaderSlot {
+		atomic<uint64_t> epoch{ 0 };
+	};
+
+	/// <summary>
+	/// table of reader slots, next tables are added when all slots are taken
+	/// </summary>
+	struct ReaderSlots {
+		ReaderSlots(size_t size) :slots(size) {}
+
+		vector<ReaderSlot> slots;
+		atomic<ReaderSlots*> next{ nullptr };
+	};
+
+	/// <summary>
+	/// returns the next table of slots, it is created if it does not exist
+	/// </summary>
+	/// <param name="slots">full table</param>
+	/// <returns>next table</returns>
+	static ReaderSlots* getNextSlots(ReaderSlots& slots);
+
+	/// <summary>
+	/// installs new version, old version is retired
+	/// </summary>
+	/// <param name="snapshot">new version</param>
+	void publish(const Snapshot* snapshot);
+
+	/// <summary>
+	/// deletes retired versions older than epoch of every reader, writer mutex must be held
+	/// </summary>
+	void reclaimRetired();
+
+	/// <summary>
+	/// the last published version
+	/// </summary>
+	atomic<const Snapshot*> current;
+
+	/// <summary>
+	/// incremented after every publish, readers announce it
+	/// </summary>
+	atomic<uint64_t> epoch{ 1 };
+
+	/// <summary>
+	/// the first table of reader slots
+	/// </summary>
+	mutable ReaderSlots readerSlots;
+
+	/// <summary>
+	/// replaced versions with epoch when they were replaced, ordered by epoch
+	/// </summary>
+	deque<tuple<uint64_t, unique_ptr<const Snapshot>>> retired;
+
+	/// <summary>
+	/// mutex held by the current update
+	/// </summary>
+	mutex writerMtx;
+
+	/// <summary>
+	/// number of nodes in one block
+	/// </summary>
+	id_t blockSize;
+};
+
+template<typename Cost_t>
+template<typename Func_t>
+inline void GraphSnapshot<Cost_t>::forEachNeighbour(id_t id, Func_t&& func) const
+{
+	for (const auto& [neigbourId, cost] : getNeighbours(id)) {
+		func(neigbourId, cost);
+	}
+}
+
+template<typename Cost_t>
+inline VersionedGraph<Cost_t>::VersionedGraph(id_t size, id_t blockSize)
+	:readerSlots(max(64u, thread::hardware_concurrency() * 4)), blockSize(max(blockSize, 1u))
+{
+	vector<shared_ptr<const Block>> blocks;
+
+	for (id_t first = 0; first < size; first += this->blockSize) {
+		auto block = make_shared<Block>();
+		block->nodes.resize(min(this->blockSize, size - first));
+		blocks.push_back(block);
+	}
+
+	current = new Snapshot(move(blocks), size, this->blockSize, 0);
+}
+
+template<typename Cost_t>
+inline VersionedGraph<Cost_t>::VersionedGraph(const vector<shared_ptr<NodeInPath<Cost_t>>>& graph, id_t blockSize)
+	:readerSlots(max(64u, thread::hardware_concurrency() * 4)), blockSize(max(blockSize, 1u))
+{
+	auto size = static_cast<id_t>(graph.size());
+	vector<shared_ptr<const Block>> blocks;
+
+	for (id_t first = 0; first < size; first += this->blockSize) {
+		auto block = make_shared<Block>();
+		block->nodes.resize(min(this->blockSize, size - first));
+
+		for (id_t id = first; id < first + block->nodes.size(); id++) {
+			auto& neighbours = block->nodes[id - first];
+
+			for (const auto& [weakNeighbour, cost] : graph[id]->getNeighbours()) {
+				auto neighbour = weakNeighbour.lock();
+				if (neighbour != nullptr) {
+					neighbours.push_back(tuple<id_t, Cost_t>(neighbour->getId(), cost));
+				}
+			}
+		}
+		blocks.push_back(block);
+	}
+
+	current = new Snapshot(move(blocks), size, this->blockSize, 0);
+}
+
+template<typename Cost_t>
+inline VersionedGraph<Cost_t>::~VersionedGraph()
+{
+	delete current.load();
+
+	for (auto slots = readerSlots.next.load(); slots != nullptr;) {
+		auto next = slots->next.load();
+		delete slots;
+		slots = next;
+	}
+}
+
+template<typename Cost_t>
+inline typename VersionedGraph<Cost_t>::SnapshotPtr VersionedGraph<Cost_t>::getSnapshot() const
+{
+	//threads start in different slots, so usually the first slot is free and owned only by this thread
+	auto firstIndex = hash<thread::id>()(this_thread::get_id());
+
+	//every table is scanned once, so the search ends at the first table with free slot
+	for (auto slots = &readerSlots;; slots = getNextSlots(*slots)) {
+		auto size = slots->slots.size();
+
+		for (size_t i = 0; i < size; i++) {
+			auto& slot = slots->slots[(firstIndex + i) % size].epoch;
+			uint64_t freeSlot = 0;
+
+			if (slot.load(memory_order_relaxed) == 0 && slot.compare_exchange_strong(freeSlot, epoch.load())) {
+				//version is loaded after the epoch is announced, writer cannot delete it
+				return SnapshotPtr(&slot, current.load());
+			}
+		}
+	}
+}
+
+template<typename Cost_t>
+inline typename VersionedGraph<Cost_t>::ReaderSlots* VersionedGraph<Cost_t>::getNextSlots(ReaderSlots& slots)
+{
+	auto next = slots.next.load();
+
+	if (next == nullptr) {
+		auto created = new ReaderSlots(slots.slots.size() * 2);
+
+		//other reader could add the table first
+		if (slots.next.compare_exchange_strong(next, created)) {
+			next = created;
+		}
+		else {
+			delete created;
+		}
+	}
+
+	return next;
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::addNeighbour(id_t from, id_t to, Cost_t pathCost)
+{
+	auto update = beginUpdate();
+	update.addNeighbour(from, to, pathCost);
+	update.publish();
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::reclaim()
+{
+	lock_guard<mutex> lock(writerMtx);
+	reclaimRetired();
+}
+
+template<typename Cost_t>
+inline size_t VersionedGraph<Cost_t>::getRetiredCount()
+{
+	lock_guard<mutex> lock(writerMtx);
+	return retired.size();
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::publish(const Snapshot* snapshot)
+{
+	auto old = current.exchange(snapshot);
+
+	//readers which announce this epoch or newer load the new version
+	retired.push_back(tuple<uint64_t, unique_ptr<const Snapshot>>(++epoch, old));
+
+	reclaimRetired();
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::reclaimRetired()
+{
+	auto oldestEpoch = numeric_limits<uint64_t>::max();
+
+	for (auto slots = &readerSlots; slots != nullptr; slots = slots->next.load()) {
+		for (const auto& slot : slots->slots) {
+			auto readerEpoch = slot.epoch.load();
+			if (readerEpoch != 0) {
+				oldestEpoch = min(oldestEpoch, readerEpoch);
+			}
+		}
+	}
+
+	//reader with older epoch could load any version retired after it
+	while (!retired.empty() && get<0>(retired.front()) <= oldestEpoch) {
+		retired.pop_front();
+	}
+}
+
+template<typename Cost_t>
+inline typename VersionedGraph<Cost_t>::SnapshotPtr& VersionedGraph<Cost_t>::SnapshotPtr::operator=(SnapshotPtr&& other) noexcept
+{
+	if (this != &other) {
+		reset();
+		swap(slot, other.slot);
+		swap(snapshot, other.snapshot);
+	}
+	return *this;
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::SnapshotPtr::reset()
+{
+	if (slot != nullptr) {
+		slot->store(0, memory_order_release);
+	}
+	slot = nullptr;
+	snapshot = nullptr;
+}
+
+template<typename Cost_t>
+inline VersionedGraph<Cost_t>::Update::Update(VersionedGraph& graph)
+	:graph(graph), lock(graph.writerMtx)
+{
+	//only writers change the current version
+	auto snapshot = graph.current.load();
+
+	blocks = snapshot->getBlocks();
+	writableBlocks.resize(blocks.size());
+	nodeCount = snapshot->getNodeCount();
+}
+
+template<typename Cost_t>
+inline id_t VersionedGraph<Cost_t>::Update::addNode()
+{
+	auto id = nodeCount++;
+	auto blockIndex = id / graph.blockSize;
+
+	if (blockIndex == blocks.size()) {
+		//new block is not published yet, so it is changed in place
+		auto block = make_shared<Block>();
+		blocks.push_back(block);
+		writableBlocks.push_back(block);
+	}
+
+	getWritableBlock(blockIndex).nodes.emplace_back();
+
+	return id;
+}
+
+template<typename Cost_t>
+inline void VersionedGraph<Cost_t>::Update::addNeighbour(id_t from, id_t to, Cost_t pathCost)
+{
+	assert(from < nodeCount && to < nodeCount);
+
+	getWritable(from).push_back(tuple<id_t, Cost_t>(to, pathCost));
+}
+
+template<typename Cost_t>
+inline bool VersionedGraph<Cost_t>::Update::setCost(id_t from, id_t to, Cost_t pathCost)
+{
+	const auto& neighbours = blocks[from / graph.blockSize]->nodes[from % graph.blockSize];
+
+	//block is not copied when there is nothing to change
+	if (none_of(neighbours.begin(), neighbours.end(), [to](const auto& neighbour) { return get<0>(neighbour) == to; })) {
+		return false;
+	}
+
+	for (auto& [neigbourId, cost] : getWritable(from)) {
+		if (neigbourId == to) {
+			cost = pathCost;
+		}
+	}
+	return true;
+}
+
+template<typename Cost_t>
+inline bool VersionedGraph<Cost_t>::Update::removeNeighbour(id_t from, id_t to)
+{
+	const auto& neighbours = blocks[from / graph.blockSize]->nodes[from % graph.blockSize];
+
+	if (none_of(neighbours.begin(), neighbours.end(), [to](const auto& neighbour) { return get<0>(neighbour) == to; })) {
+		return false;
+	}
+
+	auto& writable = getWritable(from);
+	writable.erase(remove_if(writable.begin(), writable.end(),
+		[to](const auto& neighbour) { return get<0>(neighbour) == to; }), writable.end());
+	return true;
+}
+
+template<typename Cost_t>
+inline uint64_t VersionedGraph<Cost_t>::Update::publish()
+{
+	auto version = graph.current.load()->getVersion() + 1;
+
+	graph.publish(new Snapshot(blocks, nodeCount, graph.blockSize, version));
+
+	//published blocks must not be changed any more
+	writableBlocks.assign(blocks.size(), nullptr);
+
+	return version;
+}
+
+template<typename Cost_t>
+inline typename VersionedGraph<Cost_t>::Block& VersionedGraph<Cost_t>::Update::getWritableBlock(size_t blockIndex)
+{
+	if (writableBlocks[blockIndex] == nullptr) {
+		writableBlocks[blockIndex] = make_shared<Block>(*blocks[blockIndex]);
+		blocks[blockIndex] = writableBlocks[blockIndex];
+	}
+
+	return *writableBlocks[blockIndex];
+}
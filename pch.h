@@ -11,21 +11,27 @@
 #include "framework.h"
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <map>
 #include <set>
 #include <functional>
 #include <unordered_map>
 #include <tuple>
 #include <limits>
+#include <cstdint>
+#include <cmath>
 #include <assert.h>
 #include <deque>
+#include <list>
 #include <algorithm>
 #include <mutex>
 #include <future>
 #include <queue>
 #include <utility>
+#include <random>
 #include <thread>
 #include <atomic>
+#include <chrono>
 #include "types.h"
 using namespace std;
 